@@ -0,0 +1,388 @@
+// ---------------------------------
+// projects/g++/graph/BenchGraph.c++
+// Copyright (C) 2015
+// Glenn P. Downing
+// ---------------------------------
+
+// --------
+// includes
+// --------
+
+#include <algorithm> // max, shuffle
+#include <chrono>    // steady_clock
+#include <cmath>     // ceil, log2, sqrt
+#include <cstdio>    // fflush, fopen, fprintf, fscanf, printf
+#include <cstdint>   // uint64_t
+#include <cstdlib>   // atol, exit
+#include <cstring>   // strcmp
+#include <iterator>  // distance
+#include <random>    // mt19937_64, uniform_int_distribution, uniform_real_distribution
+#include <string>    // string
+#include <thread>    // thread
+#include <utility>   // make_pair, pair
+#include <vector>    // vector
+
+#include <sys/resource.h> // getrusage
+#include <sys/wait.h>     // waitpid
+#include <unistd.h>       // fork, sysconf
+
+#include "boost/graph/adjacency_list.hpp" // adjacency_list
+
+#include "Graph.h"
+#include "GraphAlgorithms.h"
+
+using namespace std;
+
+// -----------
+// graph_types
+// -----------
+
+// the same pairing as the typed tests in TestGraph.c++
+typedef boost::adjacency_list<boost::setS, boost::vecS, boost::directedS> boost_graph;
+
+template <typename G>
+struct graph_name;
+
+template <>
+struct graph_name<boost_graph> {
+    static const char* value () {
+        return "boost::adjacency_list";}};
+
+template <>
+struct graph_name<Graph> {
+    static const char* value () {
+        return "Graph";}};
+
+template <>
+struct graph_name<ArenaGraph> {
+    static const char* value () {
+        return "ArenaGraph";}};
+
+typedef pair<int, int> edge_pair;
+
+// ----------
+// generators
+// ----------
+
+/**
+ * m pairs over m / 16 vertices, each endpoint uniform
+ */
+vector<edge_pair> uniform_edges (long m) {
+    const int                          n = max(2L, m / 16);
+    mt19937_64                         r(378);
+    uniform_int_distribution<int>      d(0, n - 1);
+    vector<edge_pair>                  v(m);
+    for (long i = 0; i != m; ++i)
+        v[i] = make_pair(d(r), d(r));
+    return v;}
+
+/**
+ * m pairs over the next power of two above m / 16 vertices
+ * recursive matrix (R-MAT) with a = 0.57, b = 0.19, c = 0.19, giving a power-law degree distribution
+ */
+vector<edge_pair> rmat_edges (long m) {
+    const int                         k = max(1, (int) ceil(log2(max(2L, m / 16))));
+    mt19937_64                        r(378);
+    uniform_real_distribution<double> d(0, 1);
+    vector<edge_pair>                 v(m);
+    for (long i = 0; i != m; ++i) {
+        int u = 0;
+        int w = 0;
+        for (int j = 0; j != k; ++j) {
+            const double x = d(r);
+            u = (u << 1) | (x >= 0.76);
+            w = (w << 1) | (((x >= 0.57) && (x < 0.76)) || (x >= 0.95));}
+        v[i] = make_pair(u, w);}
+    return v;}
+
+/**
+ * m pairs over sqrt(2 m) vertices, so about half of all possible edges
+ */
+vector<edge_pair> dense_edges (long m) {
+    const int                     n = max(2, (int) sqrt(2.0 * m));
+    mt19937_64                    r(378);
+    uniform_int_distribution<int> d(0, n - 1);
+    vector<edge_pair>             v(m);
+    for (long i = 0; i != m; ++i)
+        v[i] = make_pair(d(r), d(r));
+    return v;}
+
+// ------
+// memory
+// ------
+
+/**
+ * @return bytes currently resident
+ */
+long current_rss () {
+    long  pages = 0;
+    long  rss   = 0;
+    FILE* f     = fopen("/proc/self/statm", "r");
+    if (f != 0) {
+        if (fscanf(f, "%ld %ld", &pages, &rss) != 2)
+            rss = 0;
+        fclose(f);}
+    return rss * sysconf(_SC_PAGESIZE);}
+
+/**
+ * @return most bytes ever resident
+ */
+long peak_rss () {
+    rusage u;
+    getrusage(RUSAGE_SELF, &u);
+    return u.ru_maxrss * 1024L;}
+
+// ------
+// report
+// ------
+
+struct bench_case {
+    const char* graph;
+    const char* generator;
+    long        pairs;};
+
+/**
+ * prints one JSON object per line
+ */
+void report (const bench_case& c, const char* op, long n, double seconds) {
+    printf("{\"graph\": \"%s\", \"generator\": \"%s\", \"pairs\": %ld, \"op\": \"%s\", \"count\": %ld, \"seconds\": %.6f, \"per_second\": %.1f}\n",
+           c.graph, c.generator, c.pairs, op, n, seconds, (seconds > 0) ? n / seconds : 0.0);}
+
+void report_threads (const bench_case& c, const char* op, int threads, long n, double seconds) {
+    printf("{\"graph\": \"%s\", \"generator\": \"%s\", \"pairs\": %ld, \"op\": \"%s\", \"threads\": %d, \"count\": %ld, \"seconds\": %.6f, \"per_second\": %.1f}\n",
+           c.graph, c.generator, c.pairs, op, threads, n, seconds, (seconds > 0) ? n / seconds : 0.0);}
+
+void report_ordering (const bench_case& c, const char* op, const char* ordering, long n, double seconds) {
+    printf("{\"graph\": \"%s\", \"generator\": \"%s\", \"pairs\": %ld, \"op\": \"%s\", \"ordering\": \"%s\", \"count\": %ld, \"seconds\": %.6f, \"per_second\": %.1f}\n",
+           c.graph, c.generator, c.pairs, op, ordering, n, seconds, (seconds > 0) ? n / seconds : 0.0);}
+
+void report_memory (const bench_case& c, long vertices, long edges, long bytes) {
+    printf("{\"graph\": \"%s\", \"generator\": \"%s\", \"pairs\": %ld, \"op\": \"memory\", \"vertices\": %ld, \"edges\": %ld, \"bytes_per_edge\": %.2f, \"peak_rss_bytes\": %ld}\n",
+           c.graph, c.generator, c.pairs, vertices, edges, (edges > 0) ? double(bytes) / edges : 0.0, peak_rss());}
+
+template <typename F>
+double seconds (F f) {
+    chrono::steady_clock::time_point b = chrono::steady_clock::now();
+    f();
+    chrono::steady_clock::time_point e = chrono::steady_clock::now();
+    return chrono::duration<double>(e - b).count();}
+
+// ------------
+// construction
+// ------------
+
+template <typename G>
+G* construct (const vector<edge_pair>& v, int) {
+    return new G(v.begin(), v.end());}
+
+template <>
+boost_graph* construct<boost_graph> (const vector<edge_pair>& v, int n) {
+    return new boost_graph(v.begin(), v.end(), n);}
+
+// -----
+// bench
+// -----
+
+/**
+ * times every operation on one graph type over one edge list
+ */
+template <typename G>
+void bench (const char* generator, const vector<edge_pair>& v) {
+    typedef typename G::vertex_descriptor  vertex_descriptor;
+    typedef typename G::edge_iterator      edge_iterator;
+    typedef typename G::adjacency_iterator adjacency_iterator;
+
+    const bench_case c = {graph_name<G>::value(), generator, (long) v.size()};
+
+    int n = 0;
+    for (size_t i = 0; i != v.size(); ++i)
+        n = max(n, max(v[i].first, v[i].second) + 1);
+
+    {
+    G g;
+    report(c, "add_vertex", n, seconds([&] {
+        for (int i = 0; i != n; ++i)
+            add_vertex(g);}));
+    }
+
+    const long before = current_rss();
+    G* g = new G;
+    report(c, "add_edge", v.size(), seconds([&] {
+        for (size_t i = 0; i != v.size(); ++i)
+            add_edge(v[i].first, v[i].second, *g);}));
+    report_memory(c, num_vertices(*g), num_edges(*g), current_rss() - before);
+
+    G* h = 0;
+    report(c, "construct", v.size(), seconds([&] {
+        h = construct<G>(v, n);}));
+    delete h;
+
+    mt19937_64                    r(378);
+    uniform_int_distribution<int> d(0, n - 1);
+    vector<edge_pair>             q(v.size());
+    for (size_t i = 0; i != q.size(); ++i)
+        q[i] = (i % 2 == 0) ? v[i] : make_pair(d(r), d(r));
+    long found = 0;
+    report(c, "edge", q.size(), seconds([&] {
+        for (size_t i = 0; i != q.size(); ++i)
+            found += edge(q[i].first, q[i].second, *g).second;}));
+
+    long sum = 0;
+    report(c, "adjacent_vertices", num_edges(*g), seconds([&] {
+        for (int u = 0; u != n; ++u) {
+            pair<adjacency_iterator, adjacency_iterator> p = adjacent_vertices(vertex_descriptor(u), *g);
+            for (; p.first != p.second; ++p.first)
+                sum += *p.first;}}));
+
+    report(c, "edges", num_edges(*g), seconds([&] {
+        pair<edge_iterator, edge_iterator> p = edges(*g);
+        for (; p.first != p.second; ++p.first)
+            ++sum;}));
+
+    const long m = num_edges(*g);
+    report(c, "destroy", m, seconds([&] {
+        delete g;}));
+
+    if ((found < 0) || (sum < 0))
+        printf("\n");}
+
+/**
+ * times concurrent add_edge into a ConcurrentGraph with 1, 2, 4, ... threads,
+ * up to twice the number of cores and at least 8
+ */
+void bench_concurrent (const char* generator, const vector<edge_pair>& v) {
+    const bench_case c = {"ConcurrentGraph", generator, (long) v.size()};
+
+    const int most = max(8, 2 * (int) thread::hardware_concurrency());
+    for (int t = 1; t <= most; t *= 2) {
+        ConcurrentGraph g;
+        report_threads(c, "add_edge", t, v.size(), seconds([&] {
+            vector<thread> threads;
+            for (int i = 0; i != t; ++i)
+                threads.push_back(thread([&, i] {
+                    const size_t b = v.size() * i       / t;
+                    const size_t e = v.size() * (i + 1) / t;
+                    for (size_t j = b; j != e; ++j)
+                        add_edge(v[j].first, v[j].second, g);}));
+            for (int i = 0; i != t; ++i)
+                threads[i].join();}));}}
+
+/**
+ * times triangle counting and local clustering on a Graph with every supported intersection kernel
+ */
+void bench_triangles (const char* generator, const vector<edge_pair>& v) {
+    const bench_case c = {"Graph", generator, (long) v.size()};
+
+    const Graph g(v.begin(), v.end());
+
+    const intersect_kernel ks[]    = {scalar_kernel,   sse2_kernel,   avx2_kernel};
+    const char*            names[] = {"scalar",        "sse2",        "avx2"};
+    for (int k = 0; k != 3; ++k) {
+        if (!kernel_supported(ks[k]))
+            continue;
+        uint64_t       t = 0;
+        vector<double> l;
+        const double   s1 = seconds([&] {
+            t = count_triangles(g, default_pool(), ks[k]);});
+        const double   s2 = seconds([&] {
+            l = local_clustering_coefficients(g, default_pool(), ks[k]);});
+        printf("{\"graph\": \"%s\", \"generator\": \"%s\", \"pairs\": %ld, \"op\": \"count_triangles\", \"kernel\": \"%s\", \"threads\": %d, \"triangles\": %lu, \"count\": %ld, \"seconds\": %.6f, \"per_second\": %.1f}\n",
+               c.graph, c.generator, c.pairs, names[k], (int) default_pool().size(), (unsigned long) t, (long) num_edges(g), s1, num_edges(g) / s1);
+        printf("{\"graph\": \"%s\", \"generator\": \"%s\", \"pairs\": %ld, \"op\": \"local_clustering\", \"kernel\": \"%s\", \"threads\": %d, \"count\": %ld, \"seconds\": %.6f, \"per_second\": %.1f}\n",
+               c.graph, c.generator, c.pairs, names[k], (int) default_pool().size(), (long) num_edges(g), s2, num_edges(g) / s2);}}
+
+/**
+ * times traversals of a Graph whose ids were scrambled, as if they came from an external system,
+ * then relabels a copy with each vertex ordering and times the same traversals again
+ * bfs is breadth_first_levels from the greatest-degree vertex,
+ * pull sums a per-vertex value over every vertex's adjacent vertices
+ */
+void bench_reorder (const char* generator, const vector<edge_pair>& v) {
+    const bench_case c = {"Graph", generator, (long) v.size()};
+
+    Graph g(v.begin(), v.end());
+    const int n = num_vertices(g);
+    {
+    vector<int> p(n);
+    for (int u = 0; u != n; ++u)
+        p[u] = u;
+    shuffle(p.begin(), p.end(), mt19937_64(378));
+    relabel(p, g);
+    }
+
+    int s = 0;
+    for (int u = 0; u != n; ++u)
+        if (distance(adjacent_vertices(u, g).first, adjacent_vertices(u, g).second) > distance(adjacent_vertices(s, g).first, adjacent_vertices(s, g).second))
+            s = u;
+
+    const vertex_ordering os[]    = {degree_ordering, cuthill_mckee_ordering, bfs_ordering};
+    const char*           names[] = {"degree",        "cuthill_mckee",        "bfs"};
+    for (int k = -1; k != 3; ++k) {
+        Graph       h = g;
+        vector<int> r(n);
+        for (int u = 0; u != n; ++u)
+            r[u] = u;
+        const char* name = (k < 0) ? "scrambled" : names[k];
+        if (k >= 0)
+            report_ordering(c, "reorder", name, num_edges(h), seconds([&] {
+                r = reorder(h, os[k]);}));
+
+        vector<int> d;
+        report_ordering(c, "bfs", name, num_edges(h), seconds([&] {
+            d = breadth_first_levels(r[s], h);}));
+
+        vector<double> x(n, 1);
+        vector<double> y(n, 0);
+        report_ordering(c, "pull", name, num_edges(h), seconds([&] {
+            for (int u = 0; u != n; ++u) {
+                double t = 0;
+                for (Graph::adjacency_iterator i = adjacent_vertices(u, h).first; i != adjacent_vertices(u, h).second; ++i)
+                    t += x[*i];
+                y[u] = t;}}));
+        if (y.empty() || d.empty())
+            printf("\n");}}
+
+// ----
+// main
+// ----
+
+/**
+ * runs each (graph, generator, size) case in its own child process, so peak RSS is per case
+ * usage: BenchGraph [max pairs, default 10000000] [generator]
+ */
+int main (int argc, char** argv) {
+    const long  largest = (argc > 1) ? atol(argv[1]) : 10000000L;
+    const char* only    = (argc > 2) ? argv[2] : 0;
+
+    typedef vector<edge_pair> (*generator)(long);
+    const char* names[] = {"uniform",     "rmat",     "dense"};
+    generator   gens[]  = {uniform_edges, rmat_edges, dense_edges};
+
+    for (long m = 1000; m <= largest; m *= 10) {
+        for (int i = 0; i != 3; ++i) {
+            if ((only != 0) && (strcmp(only, names[i]) != 0))
+                continue;
+            for (int j = 0; j != 6; ++j) {
+                fflush(stdout);
+                pid_t p = fork();
+                if (p == 0) {
+                    vector<edge_pair> v = gens[i](m);
+                    if (j == 0)
+                        bench<boost_graph>(names[i], v);
+                    else if (j == 1)
+                        bench<Graph>(names[i], v);
+                    else if (j == 2)
+                        bench<ArenaGraph>(names[i], v);
+                    else if (j == 3)
+                        bench_concurrent(names[i], v);
+                    else if (j == 4)
+                        bench_triangles(names[i], v);
+                    else
+                        bench_reorder(names[i], v);
+                    fflush(stdout);
+                    exit(0);}
+                int status = 0;
+                waitpid(p, &status, 0);
+                if (!WIFEXITED(status) || (WEXITSTATUS(status) != 0))
+                    fprintf(stderr, "BenchGraph: %s case with %ld pairs failed\n", names[i], m);}}}
+    return 0;}
@@ -11,33 +11,382 @@
 // includes
 // --------
 
-#include <cassert> // assert
-#include <cstddef> // size_t
-#include <utility> // make_pair, pair
-#include <vector>  // vector
+#include <algorithm>   // binary_search, fill, lower_bound, max, max_element, min, set_union, sort, unique
+#include <atomic>      // atomic
+#include <cassert>     // assert
+#include <cstddef>     // ptrdiff_t, size_t
+#include <cstdint>     // int32_t, uint32_t, uint64_t, uintptr_t
+#include <cstring>     // memcmp
+#include <fstream>     // ofstream
+#include <iterator>    // back_inserter, distance, forward_iterator_tag, iterator_traits, random_access_iterator_tag
+#include <limits>      // numeric_limits
+#include <memory>      // allocator, allocator_traits, make_shared, shared_ptr, unique_ptr
+#include <mutex>       // lock_guard, mutex
+#include <new>         // operator new
+#include <stdexcept>   // invalid_argument, runtime_error
+#include <string>      // string
+#include <type_traits> // true_type
+#include <utility>     // make_pair, move, pair, swap
+#include <vector>      // vector
+
+#include <fcntl.h>    // open
+#include <sys/mman.h> // mmap, munmap
+#include <sys/stat.h> // fstat
+#include <unistd.h>   // close
+
+#include "ThreadPool.h"
+
+class FrozenGraph;
 
 // -----
-// Graph
+// Arena
 // -----
 
-class Graph {
+/**
+ * memory arena: carves allocations out of large blocks by bumping a pointer,
+ * rounds every request up to a power of two, and keeps freed pieces on one free list
+ * per size so a growing vector's old buffer is reused by the next request of that size
+ * the blocks are only returned to the system, all at once, when the arena is destroyed
+ * not thread safe
+ */
+class Arena {
+    private:
+        // ---------
+        // constants
+        // ---------
+
+        static const std::size_t min_size    = 16;
+        static const std::size_t class_count = 48;
+
+        // ----
+        // data
+        // ----
+
+        std::vector<char*> _blocks;
+        char*              _next;
+        std::size_t        _left;
+        std::size_t        _block_size;
+        std::size_t        _reserved;
+        void*              _free[class_count];
+
+        /**
+         * @return index k of the smallest size min_size << k that holds n bytes
+         */
+        static std::size_t size_class (std::size_t n) {
+            std::size_t k = 0;
+            while ((min_size << k) < n)
+                ++k;
+            return k;}
+
+    public:
+        // ------------
+        // constructors
+        // ------------
+
+        /**
+         * @param size of the first block in bytes, later blocks double up to 64 MiB
+         */
+        explicit Arena (std::size_t block_size = 64 * 1024) :
+                _next       (0),
+                _left       (0),
+                _block_size (block_size),
+                _reserved   (0) {
+            std::fill(_free, _free + class_count, static_cast<void*>(0));}
+
+        ~Arena () {
+            for (std::size_t i = 0; i != _blocks.size(); ++i)
+                ::operator delete(_blocks[i]);}
+
+        Arena             (const Arena&) = delete;
+        Arena& operator = (const Arena&) = delete;
+
+        // --------
+        // allocate
+        // --------
+
+        /**
+         * @param number of bytes
+         * @param alignment, a power of two no larger than min_size
+         * @return pointer to n bytes that stay valid until deallocated or the arena is destroyed
+         */
+        void* allocate (std::size_t n, std::size_t align) {
+            assert(align <= min_size);
+            const std::size_t k = size_class(n);
+            if (_free[k] != 0) {
+                void* p  = _free[k];
+                _free[k] = *static_cast<void**>(p);
+                return p;}
+            n = min_size << k;
+            if (_left < n) {
+                std::size_t size = std::max(_block_size, n);
+                _blocks.push_back(static_cast<char*>(::operator new(size)));
+                _next       = _blocks.back();
+                _left       = size;
+                _reserved  += size;
+                _block_size = std::min<std::size_t>(_block_size * 2, 64 * 1024 * 1024);}
+            void* p = _next;
+            _next += n;
+            _left -= n;
+            return p;}
+
+        // ----------
+        // deallocate
+        // ----------
+
+        /**
+         * @param pointer from allocate
+         * @param the number of bytes it was allocated with
+         * keeps the piece for the next request of the same size
+         */
+        void deallocate (void* p, std::size_t n) {
+            const std::size_t k = size_class(n);
+            *static_cast<void**>(p) = _free[k];
+            _free[k] = p;}
+
+        // --------------
+        // bytes_reserved
+        // --------------
+
+        /**
+         * @return bytes taken from the system so far
+         */
+        std::size_t bytes_reserved () const {
+            return _reserved;}};
+
+// --------------
+// ArenaAllocator
+// --------------
+
+/**
+ * standard allocator over an Arena it does not own
+ * holds a plain pointer, so an adjacency costs one word more than with std::allocator,
+ * and copying or destroying one does no reference counting
+ * a default-constructed allocator has no arena and can't allocate;
+ * a BasicGraph given one, or copied, creates an arena of its own, see graph_storage
+ */
+template <typename T>
+class ArenaAllocator {
+    template <typename U>
+    friend class ArenaAllocator;
+
     public:
         // --------
         // typedefs
         // --------
 
+        typedef T value_type;
+
+        typedef std::true_type propagate_on_container_copy_assignment;
+        typedef std::true_type propagate_on_container_move_assignment;
+        typedef std::true_type propagate_on_container_swap;
+
+    private:
+        // ----
+        // data
+        // ----
+
+        Arena* _arena;
+
+    public:
+        // ------------
+        // constructors
+        // ------------
+
+        ArenaAllocator () :
+                _arena (0)
+            {}
+
+        explicit ArenaAllocator (Arena* a) :
+                _arena (a)
+            {}
+
+        template <typename U>
+        ArenaAllocator (const ArenaAllocator<U>& rhs) :
+                _arena (rhs._arena)
+            {}
+
+        // --------
+        // allocate
+        // --------
+
+        T* allocate (std::size_t n) {
+            assert(_arena != 0);
+            return static_cast<T*>(_arena->allocate(n * sizeof(T), alignof(T)));}
+
+        void deallocate (T* p, std::size_t n) {
+            _arena->deallocate(p, n * sizeof(T));}
+
+        // -----
+        // arena
+        // -----
+
+        Arena* arena () const {
+            return _arena;}
+
+        template <typename U>
+        friend bool operator == (const ArenaAllocator& lhs, const ArenaAllocator<U>& rhs) {
+            return lhs._arena == rhs._arena;}
+
+        template <typename U>
+        friend bool operator != (const ArenaAllocator& lhs, const ArenaAllocator<U>& rhs) {
+            return !(lhs == rhs);}};
+
+// -------------
+// graph_storage
+// -------------
+
+/**
+ * what a BasicGraph<A> keeps, besides its containers, to hand them their allocator
+ * most allocators are self-contained, so this is just the allocator
+ */
+template <typename A>
+class graph_storage {
+    private:
+        A _a;
+
+    public:
+        /**
+         * @return the allocator a copy of a graph using a starts with
+         */
+        static A for_copy (const A& a) {
+            return std::allocator_traits<A>::select_on_container_copy_construction(a);}
+
+        explicit graph_storage (const A& a) :
+                _a (a)
+            {}
+
+        A allocator () const {
+            return _a;}
+
+        /**
+         * destroys v normally
+         */
+        template <typename V>
+        void abandon (V&) {}};
+
+/**
+ * an ArenaAllocator without an arena asks the graph for an arena of its own,
+ * which the graph frees as a whole when it goes away
+ * an ArenaAllocator with an arena is used as given, and the arena stays the caller's
+ */
+template <typename T>
+class graph_storage<ArenaAllocator<T> > {
+    private:
+        std::unique_ptr<Arena> _arena;
+        ArenaAllocator<T>      _a;
+
+    public:
+        /**
+         * @return an allocator without an arena, so a copied graph always gets an arena of its own
+         * Arena is not thread safe, and a copy handed to another thread must not share one
+         */
+        static ArenaAllocator<T> for_copy (const ArenaAllocator<T>&) {
+            return ArenaAllocator<T>();}
+
+        explicit graph_storage (const ArenaAllocator<T>& a) :
+                _arena ((a.arena() == 0) ? new Arena : 0),
+                _a     ((a.arena() == 0) ? ArenaAllocator<T>(_arena.get()) : a)
+            {}
+
+        ArenaAllocator<T> allocator () const {
+            return _a;}
+
+        /**
+         * if the arena is the graph's own, moves v's contents into an arena-allocated V
+         * that is never destroyed, so destroying v is O(1) and the arena frees everything at once
+         */
+        template <typename V>
+        void abandon (V& v) {
+            if (_arena)
+                ::new (_arena->allocate(sizeof(V), alignof(V))) V(std::move(v));}};
+
+// ----------
+// BasicGraph
+// ----------
+
+/**
+ * directed graph with sorted per-vertex adjacency vectors
+ * every container allocates through A, so a graph can live in an arena
+ * a moved-from graph may only be destroyed or assigned to
+ */
+template <typename A = std::allocator<int> >
+class BasicGraph {
+    public:
+        // --------
+        // typedefs
+        // --------
+
+        typedef A allocator_type;
+
         typedef int vertex_descriptor;  
         typedef std::pair<vertex_descriptor, vertex_descriptor> edge_descriptor;    
 
-        typedef std::vector<vertex_descriptor>::const_iterator vertex_iterator;    
-        typedef std::set<edge_descriptor>::const_iterator edge_iterator;      
-        typedef std::set<vertex_descriptor>::const_iterator adjacency_iterator; 
-        typedef std::set<edge_descriptor>     set_type;
-        typedef set_type::iterator            siterator;
+        typedef std::vector<vertex_descriptor, A> adjacency_type;
+
+        typedef typename std::vector<vertex_descriptor, A>::const_iterator vertex_iterator;    
+        typedef typename adjacency_type::const_iterator adjacency_iterator; 
 
         typedef std::size_t vertices_size_type;
         typedef std::size_t edges_size_type;
 
+        // -------------
+        // edge_iterator
+        // -------------
+
+        /**
+         * walks the per-vertex adjacencies in order, no edge list is stored
+         * yields edges sorted by (source, target)
+         */
+        class edge_iterator {
+            public:
+                typedef std::forward_iterator_tag iterator_category;
+                typedef edge_descriptor           value_type;
+                typedef std::ptrdiff_t            difference_type;
+                typedef const edge_descriptor*    pointer;
+                typedef edge_descriptor           reference;
+
+            private:
+                const BasicGraph* _p;
+                vertex_descriptor _u;
+                std::size_t       _i;
+
+                void skip () {
+                    while ((_u < (int) _p->_g.size()) && (_i == _p->_g[_u].size())) {
+                        ++_u;
+                        _i = 0;}}
+
+            public:
+                edge_iterator () :
+                        _p (0),
+                        _u (0),
+                        _i (0)
+                    {}
+
+                edge_iterator (const BasicGraph* p, vertex_descriptor u) :
+                        _p (p),
+                        _u (u),
+                        _i (0) {
+                    skip();}
+
+                friend bool operator == (const edge_iterator& lhs, const edge_iterator& rhs) {
+                    return (lhs._u == rhs._u) && (lhs._i == rhs._i);}
+
+                friend bool operator != (const edge_iterator& lhs, const edge_iterator& rhs) {
+                    return !(lhs == rhs);}
+
+                reference operator * () const {
+                    return std::make_pair(_u, _p->_g[_u][_i]);}
+
+                edge_iterator& operator ++ () {
+                    ++_i;
+                    skip();
+                    return *this;}
+
+                edge_iterator operator ++ (int) {
+                    edge_iterator x = *this;
+                    ++*this;
+                    return x;}};
+
     public:
         // --------
         // add_edge
@@ -47,25 +396,48 @@ class Graph {
          * @param 2 vertex_descriptors
          * @param Graph&
          * make an edge between the two vertices given, first is source, second is target
+         * the target is inserted in sorted position in the source's adjacency
          * @return pair with edge descriptor and bool stating whether add was successful
          */
-        friend std::pair<edge_descriptor, bool> add_edge (vertex_descriptor v1, vertex_descriptor v2, Graph& g) {
+        friend std::pair<edge_descriptor, bool> add_edge (vertex_descriptor v1, vertex_descriptor v2, BasicGraph& g) {
             edge_descriptor x = std::make_pair(v1, v2);
-            std::pair<siterator, bool> p = g._e.insert(x);
 
-            
-            bool            b  = p.second;
+            while(std::max(v1, v2) >= (int) g._g.size()){
+                add_vertex(g);
+            }
+
+            adjacency_type&                   a = g._g[v1];
+            typename adjacency_type::iterator p = std::lower_bound(a.begin(), a.end(), v2);
+            bool                              b = (p == a.end()) || (*p != v2);
 
             if(b){
-                while(std::max(v1, v2) >= (int) g._g.size()){
-                    add_vertex(g);
-                }
-                
-                g._g[v1].insert(v2);
+                a.insert(p, v2);
+                ++g._num_edges;
             }
                 
             return std::make_pair(x, b);}
 
+        // ---------
+        // add_edges
+        // ---------
+
+        /**
+         * @param iterator to beginning of a range of (source, target) pairs
+         * @param iterator to end of the range
+         * @param Graph&
+         * @param pool to run on
+         * add every edge of the range in one pass
+         * the vertex list grows once to the largest id, the batch is bucketed by source
+         * with a two-level counting sort, first by the high bits of the source into ranges of
+         * at most 1024 vertices and then within each range, and each touched adjacency is
+         * sorted, deduplicated, and merged with what is already there
+         * everything but the merge runs on the pool; the merge allocates, so it runs on the caller
+         * @return number of edges that were not already in the graph
+         */
+        template <typename II>
+        friend edges_size_type add_edges (II b, II e, BasicGraph& g, ThreadPool& pool = default_pool()) {
+            return g.add_batch(b, e, pool, typename std::iterator_traits<II>::iterator_category());}
+
         // ----------
         // add_vertex
         // ----------
@@ -75,9 +447,8 @@ class Graph {
          * add vertex to graph
          * @return vertex descriptor
          */
-        friend vertex_descriptor add_vertex (Graph& g) {
-            std::set<vertex_descriptor> x;
-            g._g.push_back(x);
+        friend vertex_descriptor add_vertex (BasicGraph& g) {
+            g._g.push_back(adjacency_type(g.get_allocator()));
             vertex_descriptor v =(g._g.size()-1);
             g._vertices_list.push_back(v);
             return v;}
@@ -91,7 +462,7 @@ class Graph {
          * @param const Graph&
          * @return pair of iterators to beginning and end list of adjacent vertices
          */
-        friend std::pair<adjacency_iterator, adjacency_iterator> adjacent_vertices (vertex_descriptor v, const Graph& g) {
+        friend std::pair<adjacency_iterator, adjacency_iterator> adjacent_vertices (vertex_descriptor v, const BasicGraph& g) {
             adjacency_iterator b = g._g[v].begin();
             adjacency_iterator e = g._g[v].end();
             return std::make_pair(b, e);}
@@ -104,14 +475,15 @@ class Graph {
          * @param 2 vertex descriptors
          * @param const Graph&
          * checks  if there is an edge between the two given vertices
+         * binary searches only the first vertex's adjacency
          * @return pair with edge descriptor and bool indicating if found
          */
-        friend std::pair<edge_descriptor, bool> edge (vertex_descriptor v1, vertex_descriptor v2, const Graph& g) {
+        friend std::pair<edge_descriptor, bool> edge (vertex_descriptor v1, vertex_descriptor v2, const BasicGraph& g) {
             edge_descriptor x = std::make_pair(v1, v2);
-            bool            b  = true;
+            bool            b  = false;
 
-            if(g._e.find(x) == g._e.end()){
-                b = false;
+            if((v1 >= 0) && (v1 < (int) g._g.size())){
+                b = std::binary_search(g._g[v1].begin(), g._g[v1].end(), v2);
             }
             
             return std::make_pair(x, b);}
@@ -122,12 +494,12 @@ class Graph {
 
         /**
          * @param const Graph&
-         * @return pair of iterators to beginning and end of set of edges
+         * @return pair of iterators to beginning and end of edges
          */
-        friend std::pair<edge_iterator, edge_iterator> edges (const Graph& g) {
+        friend std::pair<edge_iterator, edge_iterator> edges (const BasicGraph& g) {
                       
-            edge_iterator b = g._e.begin();
-            edge_iterator e = g._e.end();
+            edge_iterator b(&g, 0);
+            edge_iterator e(&g, (int) g._g.size());
             return std::make_pair(b, e);}
 
         // ---------
@@ -138,9 +510,9 @@ class Graph {
          * @param const Graph&
          * @return number of edges in graph
          */
-        friend edges_size_type num_edges (const Graph& g) {
+        friend edges_size_type num_edges (const BasicGraph& g) {
 
-            edges_size_type s = g._e.size(); 
+            edges_size_type s = g._num_edges; 
             return s;}
 
         // ------------
@@ -151,11 +523,45 @@ class Graph {
          * @param const Graph&
          * @return number of vertices in graph
          */
-        friend vertices_size_type num_vertices (const Graph& g) {
+        friend vertices_size_type num_vertices (const BasicGraph& g) {
 
             vertices_size_type s = g._vertices_list.size();
             return s;}
 
+        // -------
+        // relabel
+        // -------
+
+        /**
+         * @param old-to-new mapping, a permutation of the vertex descriptors
+         * @param Graph&
+         * renames every vertex v to p[v], keeping the edge set
+         * adjacencies are rebuilt in order of their new ids, so they also sit in that order on the heap
+         * @throws invalid_argument if p is not a permutation of [0, num_vertices)
+         */
+        friend void relabel (const std::vector<vertex_descriptor>& p, BasicGraph& g) {
+            const std::size_t n = g._g.size();
+            if (p.size() != n)
+                throw std::invalid_argument("relabel: mapping size differs from num_vertices");
+            std::vector<vertex_descriptor> q(n, -1);
+            for (std::size_t v = 0; v != n; ++v) {
+                if ((p[v] < 0) || (std::size_t(p[v]) >= n) || (q[p[v]] != -1))
+                    throw std::invalid_argument("relabel: mapping is not a permutation");
+                q[p[v]] = v;}
+
+            std::vector<adjacency_type, outer_allocator_type> h(g._g.get_allocator());
+            h.reserve(n);
+            for (std::size_t v = 0; v != n; ++v) {
+                const adjacency_type& b = g._g[q[v]];
+                h.push_back(adjacency_type(g.get_allocator()));
+                adjacency_type& a = h.back();
+                a.reserve(b.size());
+                for (std::size_t i = 0; i != b.size(); ++i)
+                    a.push_back(p[b[i]]);
+                std::sort(a.begin(), a.end());}
+            g._g.swap(h);
+            assert(g.valid());}
+
         // ------
         // source
         // ------
@@ -165,8 +571,8 @@ class Graph {
          * @param Graph&
          * @return source vertex(where the edge starts)
          */
-        friend vertex_descriptor source (edge_descriptor x, const Graph& g) {
-            if(g._e.find(x) != g._e.end()){
+        friend vertex_descriptor source (edge_descriptor x, const BasicGraph& g) {
+            if(edge(x.first, x.second, g).second){
                 return x.first;
             }
 
@@ -183,8 +589,8 @@ class Graph {
          * @param Graph&
          * @return target vertex(where the edge ends)
          */
-        friend vertex_descriptor target (edge_descriptor x, const Graph& g) {
-            if(g._e.find(x) != g._e.end()){
+        friend vertex_descriptor target (edge_descriptor x, const BasicGraph& g) {
+            if(edge(x.first, x.second, g).second){
                 return x.second;
             }
 
@@ -201,11 +607,18 @@ class Graph {
          * @param const Graph&
          * @return given value as vertex descriptor
          */
-        friend vertex_descriptor vertex (vertices_size_type v, const Graph& g) {
+        friend vertex_descriptor vertex (vertices_size_type v, const BasicGraph& g) {
 
             vertex_descriptor vd = v;
             return vd;}
 
+        // ------
+        // freeze
+        // ------
+
+        template <typename B>
+        friend FrozenGraph freeze (const BasicGraph<B>& g);
+
         // --------
         // vertices
         // --------
@@ -214,7 +627,7 @@ class Graph {
          * @param const Graph&
          * @return iterators to beginning and end of list of vertices
          */
-        friend std::pair<vertex_iterator, vertex_iterator> vertices (const Graph& g) {
+        friend std::pair<vertex_iterator, vertex_iterator> vertices (const BasicGraph& g) {
             
             vertex_iterator b = g._vertices_list.begin();
             vertex_iterator e = g._vertices_list.end();
@@ -225,9 +638,12 @@ class Graph {
         // data
         // ----
 
-        std::vector< std::set<vertex_descriptor> > _g; 
-        std::set<edge_descriptor> _e;
-        std::vector<vertex_descriptor> _vertices_list;
+        typedef typename std::allocator_traits<A>::template rebind_alloc<adjacency_type> outer_allocator_type;
+
+        graph_storage<A>                                  _storage;
+        std::vector<adjacency_type, outer_allocator_type> _g; 
+        edges_size_type _num_edges;
+        std::vector<vertex_descriptor, A> _vertices_list;
 
         // -----
         // valid
@@ -239,7 +655,590 @@ class Graph {
         bool valid () const {
 
 
-            return _g.size() >=0 && _e.size() >= 0  && _vertices_list.size() >= 0 && _g.size() == _vertices_list.size();}
+            return _g.size() >=0 && _num_edges >= 0  && _vertices_list.size() >= 0 && _g.size() == _vertices_list.size();}
+
+        // ---------
+        // add_batch
+        // ---------
+
+        /**
+         * copies a single-pass range, so the passes below can index it
+         */
+        template <typename II>
+        edges_size_type add_batch (II b, II e, ThreadPool& pool, std::input_iterator_tag) {
+            const std::vector<edge_descriptor> batch(b, e);
+            return add_batch(batch.begin(), batch.end(), pool, std::random_access_iterator_tag());}
+
+        /**
+         * see add_edges
+         */
+        template <typename RI>
+        edges_size_type add_batch (RI b, RI e, ThreadPool& pool, std::random_access_iterator_tag) {
+            const std::size_t m = e - b;
+            if (m == 0)
+                return 0;
+
+            std::vector<vertex_descriptor> highest(pool.size(), -1);
+            pool.parallel_for(0, m, 1 << 16, [&] (std::size_t i, std::size_t j, std::size_t w) {
+                vertex_descriptor h = highest[w];
+                for (; i != j; ++i)
+                    h = std::max(h, std::max(b[i].first, b[i].second));
+                highest[w] = h;});
+            const vertex_descriptor h = *std::max_element(highest.begin(), highest.end());
+            if (h >= (int) _g.size()) {
+                vertex_descriptor v = _g.size();
+                _g.resize(h + 1, adjacency_type(get_allocator()));
+                _vertices_list.reserve(h + 1);
+                while (v <= h)
+                    _vertices_list.push_back(v++);}
+
+            const std::size_t n = _g.size();
+            std::size_t       z = 0;
+            while ((n >> z) >= 1024)
+                ++z;
+            const std::size_t r = ((n - 1) >> z) + 1;
+            const std::size_t c = std::min<std::size_t>(4 * pool.size(), (m + 4095) / 4096);
+
+            std::vector<edges_size_type> counts(c * r, 0);
+            pool.parallel_for(0, c, 1, [&] (std::size_t i0, std::size_t i1, std::size_t) {
+                for (std::size_t i = i0; i != i1; ++i) {
+                    edges_size_type* h = &counts[i * r];
+                    for (std::size_t j = m * i / c; j != m * (i + 1) / c; ++j)
+                        ++h[b[j].first >> z];}});
+            std::vector<edges_size_type> starts(r + 1, 0);
+            for (std::size_t k = 0; k != r; ++k) {
+                edges_size_type x = starts[k];
+                for (std::size_t i = 0; i != c; ++i) {
+                    const edges_size_type y = counts[i * r + k];
+                    counts[i * r + k] = x;
+                    x += y;}
+                starts[k + 1] = x;}
+
+            std::vector<edge_descriptor> buckets(m);
+            pool.parallel_for(0, c, 1, [&] (std::size_t i0, std::size_t i1, std::size_t) {
+                for (std::size_t i = i0; i != i1; ++i) {
+                    edges_size_type* h = &counts[i * r];
+                    for (std::size_t j = m * i / c; j != m * (i + 1) / c; ++j)
+                        buckets[h[b[j].first >> z]++] = b[j];}});
+            std::vector<edges_size_type>().swap(counts);
+
+            std::vector<edges_size_type>   offsets(n + 1);
+            std::vector<edges_size_type>   ends(n);
+            std::vector<vertex_descriptor> targets(m);
+            offsets[n] = m;
+            pool.parallel_for(0, r, 1, [&] (std::size_t k0, std::size_t k1, std::size_t) {
+                for (std::size_t k = k0; k != k1; ++k) {
+                    const std::size_t v0 = k << z;
+                    const std::size_t v1 = std::min(n, (k + 1) << z);
+                    std::vector<edges_size_type> next(v1 - v0, 0);
+                    for (edges_size_type j = starts[k]; j != starts[k + 1]; ++j)
+                        ++next[buckets[j].first - v0];
+                    edges_size_type x = starts[k];
+                    for (std::size_t v = v0; v != v1; ++v) {
+                        offsets[v] = x;
+                        x += next[v - v0];
+                        next[v - v0] = offsets[v];}
+                    for (edges_size_type j = starts[k]; j != starts[k + 1]; ++j)
+                        targets[next[buckets[j].first - v0]++] = buckets[j].second;
+                    for (std::size_t v = v0; v != v1; ++v) {
+                        std::vector<vertex_descriptor>::iterator tb = targets.begin() + offsets[v];
+                        std::vector<vertex_descriptor>::iterator te = targets.begin() + next[v - v0];
+                        std::sort(tb, te);
+                        ends[v] = std::unique(tb, te) - targets.begin();}}});
+            std::vector<edge_descriptor>().swap(buckets);
+
+            edges_size_type k = 0;
+            adjacency_type  t(get_allocator());
+            for (std::size_t v = 0; v != n; ++v) {
+                if (offsets[v] == ends[v])
+                    continue;
+                std::vector<vertex_descriptor>::iterator tb = targets.begin() + offsets[v];
+                std::vector<vertex_descriptor>::iterator te = targets.begin() + ends[v];
+
+                adjacency_type& a = _g[v];
+                edges_size_type s = a.size();
+                if (a.empty())
+                    a.assign(tb, te);
+                else {
+                    t.clear();
+                    t.reserve(a.size() + (te - tb));
+                    std::set_union(a.begin(), a.end(), tb, te, std::back_inserter(t));
+                    a.swap(t);}
+                k += a.size() - s;}
+
+            _num_edges += k;
+            return k;}
+
+    public:
+        // ------------
+        // constructors
+        // ------------
+
+        /**
+         * default constructor
+         * creates empty graph
+         */
+        explicit BasicGraph (const A& a = A()) :
+                _storage       (a),
+                _g             (outer_allocator_type(_storage.allocator())),
+                _num_edges     (0),
+                _vertices_list (_storage.allocator()) {
+            assert(valid());}
+
+        /**
+         * @param iterator to beginning of a range of (source, target) pairs
+         * @param iterator to end of the range
+         * @param allocator
+         * creates a graph holding the edges of the range, see add_edges
+         */
+        template <typename II>
+        BasicGraph (II b, II e, const A& a = A()) :
+                _storage       (a),
+                _g             (outer_allocator_type(_storage.allocator())),
+                _num_edges     (0),
+                _vertices_list (_storage.allocator()) {
+            add_edges(b, e, *this);
+            assert(valid());}
+
+        /**
+         * @param graph to copy
+         * the copy's allocator comes from graph_storage::for_copy,
+         * so a copied ArenaGraph gets an arena of its own
+         */
+        BasicGraph (const BasicGraph& rhs) :
+                _storage       (graph_storage<A>::for_copy(rhs.get_allocator())),
+                _g             (outer_allocator_type(_storage.allocator())),
+                _num_edges     (rhs._num_edges),
+                _vertices_list (rhs._vertices_list.begin(), rhs._vertices_list.end(), _storage.allocator()) {
+            _g.reserve(rhs._g.size());
+            for (std::size_t v = 0; v != rhs._g.size(); ++v)
+                _g.push_back(adjacency_type(rhs._g[v].begin(), rhs._g[v].end(), _storage.allocator()));
+            assert(valid());}
+
+        BasicGraph (BasicGraph&&) = default;
+
+        ~BasicGraph () {
+            _storage.abandon(_g);}
+
+        BasicGraph& operator = (BasicGraph rhs) {
+            std::swap(_storage, rhs._storage);
+            _g.swap(rhs._g);
+            std::swap(_num_edges, rhs._num_edges);
+            _vertices_list.swap(rhs._vertices_list);
+            return *this;}
+
+        // -------------
+        // get_allocator
+        // -------------
+
+        /**
+         * @return allocator shared by every container of the graph
+         */
+        allocator_type get_allocator () const {
+            return _storage.allocator();}
+    };
+
+// -----
+// Graph
+// -----
+
+typedef BasicGraph<> Graph;
+
+// ----------
+// ArenaGraph
+// ----------
+
+/**
+ * Graph whose adjacencies, vertex list, and adjacency headers all live in one Arena
+ * building skips the general-purpose allocator and tearing down frees a handful of blocks
+ * each graph, copies included, owns its arena unless it was given an allocator with one;
+ * Arena is not thread safe, so graphs sharing an arena must stay on one thread
+ */
+typedef BasicGraph<ArenaAllocator<int> > ArenaGraph;
+
+
+// -----------
+// FrozenGraph
+// -----------
+
+/**
+ * immutable compressed-sparse-row snapshot of a Graph
+ * the adjacency of vertex v is _targets[_offsets[v], _offsets[v + 1]), sorted
+ * the arrays live either in memory or in a file mapped by load, and are shared by copies
+ */
+class FrozenGraph {
+    public:
+        // --------
+        // typedefs
+        // --------
+
+        typedef int vertex_descriptor;
+        typedef std::pair<vertex_descriptor, vertex_descriptor> edge_descriptor;
+
+        typedef const vertex_descriptor* adjacency_iterator;
+
+        typedef std::size_t vertices_size_type;
+        typedef std::size_t edges_size_type;
+
+        typedef std::uint64_t offset_type;
+
+        // ---------------
+        // vertex_iterator
+        // ---------------
+
+        /**
+         * counts through the vertex descriptors [0, n), like boost's counting_iterator
+         * so a FrozenGraph stores nothing per vertex beyond its offset
+         */
+        class vertex_iterator {
+            public:
+                typedef std::random_access_iterator_tag iterator_category;
+                typedef vertex_descriptor               value_type;
+                typedef std::ptrdiff_t                  difference_type;
+                typedef const vertex_descriptor*        pointer;
+                typedef vertex_descriptor               reference;
+
+            private:
+                vertex_descriptor _v;
+
+            public:
+                explicit vertex_iterator (vertex_descriptor v = 0) :
+                        _v (v)
+                    {}
+
+                friend bool operator == (const vertex_iterator& lhs, const vertex_iterator& rhs) {
+                    return lhs._v == rhs._v;}
+
+                friend bool operator != (const vertex_iterator& lhs, const vertex_iterator& rhs) {
+                    return !(lhs == rhs);}
+
+                friend bool operator < (const vertex_iterator& lhs, const vertex_iterator& rhs) {
+                    return lhs._v < rhs._v;}
+
+                friend bool operator > (const vertex_iterator& lhs, const vertex_iterator& rhs) {
+                    return rhs < lhs;}
+
+                friend bool operator <= (const vertex_iterator& lhs, const vertex_iterator& rhs) {
+                    return !(rhs < lhs);}
+
+                friend bool operator >= (const vertex_iterator& lhs, const vertex_iterator& rhs) {
+                    return !(lhs < rhs);}
+
+                friend vertex_iterator operator + (vertex_iterator lhs, difference_type n) {
+                    return lhs += n;}
+
+                friend vertex_iterator operator + (difference_type n, vertex_iterator rhs) {
+                    return rhs += n;}
+
+                friend vertex_iterator operator - (vertex_iterator lhs, difference_type n) {
+                    return lhs -= n;}
+
+                friend difference_type operator - (const vertex_iterator& lhs, const vertex_iterator& rhs) {
+                    return difference_type(lhs._v) - rhs._v;}
+
+                reference operator * () const {
+                    return _v;}
+
+                reference operator [] (difference_type n) const {
+                    return _v + n;}
+
+                vertex_iterator& operator ++ () {
+                    ++_v;
+                    return *this;}
+
+                vertex_iterator operator ++ (int) {
+                    vertex_iterator x = *this;
+                    ++*this;
+                    return x;}
+
+                vertex_iterator& operator -- () {
+                    --_v;
+                    return *this;}
+
+                vertex_iterator operator -- (int) {
+                    vertex_iterator x = *this;
+                    --*this;
+                    return x;}
+
+                vertex_iterator& operator += (difference_type n) {
+                    _v += n;
+                    return *this;}
+
+                vertex_iterator& operator -= (difference_type n) {
+                    _v -= n;
+                    return *this;}};
+
+        // -------------
+        // edge_iterator
+        // -------------
+
+        /**
+         * walks the targets array in order, tracking the source vertex
+         * yields edges in the same (source, target) order as Graph
+         */
+        class edge_iterator {
+            public:
+                typedef std::forward_iterator_tag iterator_category;
+                typedef edge_descriptor           value_type;
+                typedef std::ptrdiff_t            difference_type;
+                typedef const edge_descriptor*    pointer;
+                typedef edge_descriptor           reference;
+
+            private:
+                const FrozenGraph* _p;
+                vertex_descriptor  _u;
+                edges_size_type    _i;
+
+                void skip () {
+                    while ((_u < (int) _p->_num_vertices) && (_i == _p->_offsets[_u + 1]))
+                        ++_u;}
+
+            public:
+                edge_iterator () :
+                        _p (0),
+                        _u (0),
+                        _i (0)
+                    {}
+
+                edge_iterator (const FrozenGraph* p, vertex_descriptor u, edges_size_type i) :
+                        _p (p),
+                        _u (u),
+                        _i (i) {
+                    skip();}
+
+                friend bool operator == (const edge_iterator& lhs, const edge_iterator& rhs) {
+                    return lhs._i == rhs._i;}
+
+                friend bool operator != (const edge_iterator& lhs, const edge_iterator& rhs) {
+                    return !(lhs == rhs);}
+
+                reference operator * () const {
+                    return std::make_pair(_u, _p->_targets[_i]);}
+
+                edge_iterator& operator ++ () {
+                    ++_i;
+                    skip();
+                    return *this;}
+
+                edge_iterator operator ++ (int) {
+                    edge_iterator x = *this;
+                    ++*this;
+                    return x;}};
+
+    public:
+        // -----------------
+        // adjacent_vertices
+        // -----------------
+
+        /**
+         * @param vertex descriptor
+         * @param const FrozenGraph&
+         * @return pair of pointers to beginning and end of the sorted adjacent vertices
+         */
+        friend std::pair<adjacency_iterator, adjacency_iterator> adjacent_vertices (vertex_descriptor v, const FrozenGraph& g) {
+            adjacency_iterator b = g._targets + g._offsets[v];
+            adjacency_iterator e = g._targets + g._offsets[v + 1];
+            return std::make_pair(b, e);}
+
+        // ----
+        // edge
+        // ----
+
+        /**
+         * @param 2 vertex descriptors
+         * @param const FrozenGraph&
+         * binary searches the adjacency of the first vertex for the second
+         * @return pair with edge descriptor and bool indicating if found
+         */
+        friend std::pair<edge_descriptor, bool> edge (vertex_descriptor v1, vertex_descriptor v2, const FrozenGraph& g) {
+            edge_descriptor x = std::make_pair(v1, v2);
+            bool            b = false;
+
+            if ((v1 >= 0) && (v1 < (int) num_vertices(g))) {
+                std::pair<adjacency_iterator, adjacency_iterator> p = adjacent_vertices(v1, g);
+                b = std::binary_search(p.first, p.second, v2);}
+
+            return std::make_pair(x, b);}
+
+        // -----
+        // edges
+        // -----
+
+        /**
+         * @param const FrozenGraph&
+         * @return pair of iterators to beginning and end of edges
+         */
+        friend std::pair<edge_iterator, edge_iterator> edges (const FrozenGraph& g) {
+            edge_iterator b(&g, 0,                     0);
+            edge_iterator e(&g, (int) num_vertices(g), num_edges(g));
+            return std::make_pair(b, e);}
+
+        // ---------
+        // num_edges
+        // ---------
+
+        /**
+         * @param const FrozenGraph&
+         * @return number of edges in graph
+         */
+        friend edges_size_type num_edges (const FrozenGraph& g) {
+            return g._offsets[g._num_vertices];}
+
+        // ------------
+        // num_vertices
+        // ------------
+
+        /**
+         * @param const FrozenGraph&
+         * @return number of vertices in graph
+         */
+        friend vertices_size_type num_vertices (const FrozenGraph& g) {
+            return g._num_vertices;}
+
+        // ------
+        // source
+        // ------
+
+        /**
+         * @param edge_descriptor
+         * @param const FrozenGraph&
+         * @return source vertex(where the edge starts), -1 if not an edge
+         */
+        friend vertex_descriptor source (edge_descriptor x, const FrozenGraph& g) {
+            if (edge(x.first, x.second, g).second)
+                return x.first;
+            return -1;}
+
+        // ------
+        // target
+        // ------
+
+        /**
+         * @param edge_descriptor
+         * @param const FrozenGraph&
+         * @return target vertex(where the edge ends), -1 if not an edge
+         */
+        friend vertex_descriptor target (edge_descriptor x, const FrozenGraph& g) {
+            if (edge(x.first, x.second, g).second)
+                return x.second;
+            return -1;}
+
+        // ------
+        // vertex
+        // ------
+
+        /**
+         * @param vertices_size_type
+         * @param const FrozenGraph&
+         * @return given value as vertex descriptor
+         */
+        friend vertex_descriptor vertex (vertices_size_type v, const FrozenGraph&) {
+            vertex_descriptor vd = v;
+            return vd;}
+
+        // --------
+        // vertices
+        // --------
+
+        /**
+         * @param const FrozenGraph&
+         * @return iterators counting from the first to past the last vertex
+         */
+        friend std::pair<vertex_iterator, vertex_iterator> vertices (const FrozenGraph& g) {
+            vertex_iterator b(0);
+            vertex_iterator e(g._num_vertices);
+            return std::make_pair(b, e);}
+
+        // ------
+        // verify
+        // ------
+
+        /**
+         * @param const FrozenGraph&
+         * reads every target, O(V + E), and so faults in every page of a loaded graph
+         * @return true if every vertex's targets are sorted, distinct, and vertices
+         */
+        friend bool verify (const FrozenGraph& g) {
+            return g.valid();}
+
+        // ----
+        // load
+        // ----
+
+        friend FrozenGraph load (const std::string& path);
+
+    private:
+        // -------
+        // buffers
+        // -------
+
+        struct arrays {
+            std::vector<offset_type>       offsets;
+            std::vector<vertex_descriptor> targets;};
+
+        struct mapping {
+            void*       p;
+            std::size_t n;
+
+            mapping (void* p, std::size_t n) :
+                    p (p),
+                    n (n)
+                {}
+
+            ~mapping () {
+                munmap(p, n);}};
+
+        // ----
+        // data
+        // ----
+
+        std::shared_ptr<const void>    _storage;
+        const offset_type*             _offsets;
+        const vertex_descriptor*       _targets;
+        vertices_size_type             _num_vertices;
+
+        // -----
+        // valid
+        // -----
+
+        /**
+         * reads only the offsets, O(V)
+         * @return true if offsets start at 0, are monotone, and end at m, so every offset is at most m
+         */
+        static bool valid_offsets (const offset_type* offsets, vertices_size_type n, edges_size_type m) {
+            if ((offsets[0] != 0) || (offsets[n] != m))
+                return false;
+            for (vertices_size_type v = 0; v != n; ++v)
+                if (offsets[v] > offsets[v + 1])
+                    return false;
+            return true;}
+
+        /**
+         * checks the offsets before reading any target through them
+         * @return true if the offsets are valid, and every vertex's targets are sorted, distinct, and vertices
+         */
+        static bool valid (const offset_type* offsets, const vertex_descriptor* targets, vertices_size_type n, edges_size_type m) {
+            if (!valid_offsets(offsets, n, m))
+                return false;
+            for (vertices_size_type v = 0; v != n; ++v) {
+                for (offset_type i = offsets[v]; i != offsets[v + 1]; ++i) {
+                    if ((targets[i] < 0) || (targets[i] >= (int) n))
+                        return false;
+                    if ((i != offsets[v]) && (targets[i - 1] >= targets[i]))
+                        return false;}}
+            return true;}
+
+        bool valid () const {
+            return valid(_offsets, _targets, _num_vertices, num_edges(*this));}
+
+        /**
+         * point the view at the given arrays
+         */
+        void attach (const std::shared_ptr<const void>& storage, const offset_type* offsets, const vertex_descriptor* targets, vertices_size_type n) {
+            _storage      = storage;
+            _offsets      = offsets;
+            _targets      = targets;
+            _num_vertices = n;}
 
     public:
         // ------------
@@ -250,13 +1249,416 @@ class Graph {
          * default constructor
          * creates empty graph
          */
-        Graph () {
+        FrozenGraph () {
+            std::shared_ptr<arrays> a = std::make_shared<arrays>();
+            a->offsets.push_back(0);
+            attach(a, a->offsets.data(), a->targets.data(), 0);
+            assert(valid());}
+
+        /**
+         * @param offsets, one more than the number of vertices
+         * @param targets, sorted within each vertex's range
+         */
+        FrozenGraph (std::vector<offset_type> offsets, std::vector<vertex_descriptor> targets) {
+            assert(!offsets.empty());
+            std::shared_ptr<arrays> a = std::make_shared<arrays>();
+            a->offsets.swap(offsets);
+            a->targets.swap(targets);
+            attach(a, a->offsets.data(), a->targets.data(), a->offsets.size() - 1);
             assert(valid());}
 
         // Default copy, destructor, and copy assignment
-        // Graph  (const Graph<T>&);
-        // ~Graph ();
-        // Graph& operator = (const Graph&);
+        // copies share the underlying arrays
+        // FrozenGraph  (const FrozenGraph&);
+        // ~FrozenGraph ();
+        // FrozenGraph& operator = (const FrozenGraph&);
     };
 
+// ------
+// freeze
+// ------
+
+/**
+ * @param const Graph&
+ * build a read-only CSR snapshot; later changes to g are not reflected
+ * @return FrozenGraph with the same vertices and edges as g
+ */
+template <typename A>
+FrozenGraph freeze (const BasicGraph<A>& g) {
+    std::vector<FrozenGraph::offset_type>       offsets(g._g.size() + 1, 0);
+    std::vector<FrozenGraph::vertex_descriptor> targets;
+    targets.reserve(g._num_edges);
+    for (std::size_t v = 0; v != g._g.size(); ++v) {
+        targets.insert(targets.end(), g._g[v].begin(), g._g[v].end());
+        offsets[v + 1] = targets.size();}
+    return FrozenGraph(std::move(offsets), std::move(targets));}
+
+// ---------------
+// ConcurrentGraph
+// ---------------
+
+/**
+ * graph that many threads may add to and query at once
+ * vertices live in segments that are allocated once and never move, so growing the graph
+ * never invalidates another thread's vertex; a vertex's adjacency is a sorted vector
+ * guarded by one of a fixed set of striped locks
+ * there is no edges() or vertices(); freeze the graph once ingestion is done
+ */
+class ConcurrentGraph {
+    public:
+        // --------
+        // typedefs
+        // --------
+
+        typedef int vertex_descriptor;
+        typedef std::pair<vertex_descriptor, vertex_descriptor> edge_descriptor;
+
+        typedef std::vector<vertex_descriptor> adjacency_type;
+
+        typedef std::size_t vertices_size_type;
+        typedef std::size_t edges_size_type;
+
+    private:
+        // ---------
+        // constants
+        // ---------
+
+        static const std::size_t segment_base  = 64;
+        static const std::size_t segment_count = 26;
+        static const std::size_t lock_count    = 1024;
+
+        // ----
+        // data
+        // ----
+
+        std::atomic<adjacency_type*>    _segments[segment_count];
+        std::unique_ptr<std::mutex[]>   _locks;
+        std::atomic<vertex_descriptor>  _num_vertices;
+        std::atomic<edges_size_type>    _num_edges;
+
+        // --------
+        // segments
+        // --------
+
+        /**
+         * segment k holds segment_base * 2^k vertices, starting at vertex segment_base * (2^k - 1)
+         */
+        static std::size_t segment_of (vertex_descriptor v) {
+            std::size_t k = 0;
+            std::size_t x = v / segment_base + 1;
+            while (x >>= 1)
+                ++k;
+            return k;}
+
+        static std::size_t segment_begin (std::size_t k) {
+            return segment_base * ((std::size_t(1) << k) - 1);}
+
+        /**
+         * allocate every segment up to the one holding v, racing threads agree on one allocation
+         */
+        void reserve (vertex_descriptor v) {
+            for (std::size_t k = 0; k <= segment_of(v); ++k) {
+                if (_segments[k].load(std::memory_order_acquire) != 0)
+                    continue;
+                adjacency_type* p = new adjacency_type[segment_base << k];
+                adjacency_type* q = 0;
+                if (!_segments[k].compare_exchange_strong(q, p, std::memory_order_acq_rel))
+                    delete [] p;}}
+
+        /**
+         * make every vertex up to and including v exist
+         */
+        void grow (vertex_descriptor v) {
+            vertex_descriptor n = _num_vertices.load(std::memory_order_acquire);
+            if (v < n)
+                return;
+            reserve(v);
+            while ((n <= v) && !_num_vertices.compare_exchange_weak(n, v + 1, std::memory_order_acq_rel))
+                {}}
+
+        adjacency_type& adjacency (vertex_descriptor v) const {
+            const std::size_t k = segment_of(v);
+            return _segments[k].load(std::memory_order_acquire)[v - segment_begin(k)];}
+
+        std::mutex& lock (vertex_descriptor v) const {
+            return _locks[v % lock_count];}
+
+        // -----
+        // valid
+        // -----
+
+        /**
+         * @return true if every vertex has a segment
+         */
+        bool valid () const {
+            const vertex_descriptor n = _num_vertices.load();
+            return (n == 0) || (_segments[segment_of(n - 1)].load() != 0);}
+
+    public:
+        // --------
+        // add_edge
+        // --------
+
+        /**
+         * @param 2 vertex_descriptors
+         * @param ConcurrentGraph&
+         * make an edge between the two vertices given, first is source, second is target
+         * safe to call from many threads at once
+         * @return pair with edge descriptor and bool stating whether add was successful
+         */
+        friend std::pair<edge_descriptor, bool> add_edge (vertex_descriptor v1, vertex_descriptor v2, ConcurrentGraph& g) {
+            assert((v1 >= 0) && (v2 >= 0));
+            edge_descriptor x = std::make_pair(v1, v2);
+            g.grow(std::max(v1, v2));
+
+            bool b;
+            {
+            std::lock_guard<std::mutex> l(g.lock(v1));
+            adjacency_type&             a = g.adjacency(v1);
+            adjacency_type::iterator    p = std::lower_bound(a.begin(), a.end(), v2);
+            b = (p == a.end()) || (*p != v2);
+            if (b)
+                a.insert(p, v2);
+            }
+
+            if (b)
+                g._num_edges.fetch_add(1, std::memory_order_relaxed);
+            return std::make_pair(x, b);}
+
+        // ----------
+        // add_vertex
+        // ----------
+
+        /**
+         * @param ConcurrentGraph&
+         * add vertex to graph, safe to call from many threads at once
+         * @return vertex descriptor, distinct for every call
+         */
+        friend vertex_descriptor add_vertex (ConcurrentGraph& g) {
+            vertex_descriptor n = g._num_vertices.load(std::memory_order_acquire);
+            do
+                g.reserve(n);
+            while (!g._num_vertices.compare_exchange_weak(n, n + 1, std::memory_order_acq_rel));
+            return n;}
+
+        // -----------------
+        // adjacent_vertices
+        // -----------------
+
+        /**
+         * @param vertex descriptor
+         * @param const ConcurrentGraph&
+         * @return copy of the sorted adjacent vertices, taken under the vertex's lock
+         */
+        friend adjacency_type adjacent_vertices (vertex_descriptor v, const ConcurrentGraph& g) {
+            assert((v >= 0) && (v < (int) num_vertices(g)));
+            std::lock_guard<std::mutex> l(g.lock(v));
+            return g.adjacency(v);}
+
+        // ----
+        // edge
+        // ----
+
+        /**
+         * @param 2 vertex descriptors
+         * @param const ConcurrentGraph&
+         * checks if there is an edge between the two given vertices
+         * @return pair with edge descriptor and bool indicating if found
+         */
+        friend std::pair<edge_descriptor, bool> edge (vertex_descriptor v1, vertex_descriptor v2, const ConcurrentGraph& g) {
+            edge_descriptor x = std::make_pair(v1, v2);
+            bool            b = false;
+
+            if ((v1 >= 0) && (v1 < (int) num_vertices(g))) {
+                std::lock_guard<std::mutex> l(g.lock(v1));
+                const adjacency_type&       a = g.adjacency(v1);
+                b = std::binary_search(a.begin(), a.end(), v2);}
+
+            return std::make_pair(x, b);}
+
+        // ---------
+        // num_edges
+        // ---------
+
+        /**
+         * @param const ConcurrentGraph&
+         * @return number of edges in graph
+         */
+        friend edges_size_type num_edges (const ConcurrentGraph& g) {
+            return g._num_edges.load(std::memory_order_relaxed);}
+
+        // ------------
+        // num_vertices
+        // ------------
+
+        /**
+         * @param const ConcurrentGraph&
+         * @return number of vertices in graph
+         */
+        friend vertices_size_type num_vertices (const ConcurrentGraph& g) {
+            return g._num_vertices.load(std::memory_order_acquire);}
+
+        // ------
+        // freeze
+        // ------
+
+        /**
+         * @param const ConcurrentGraph&
+         * build a read-only CSR snapshot, locking one vertex at a time
+         * exact only once no thread is adding
+         * @return FrozenGraph with the same vertices and edges as g
+         */
+        friend FrozenGraph freeze (const ConcurrentGraph& g) {
+            const vertex_descriptor                     n = g._num_vertices.load(std::memory_order_acquire);
+            std::vector<FrozenGraph::offset_type>       offsets(n + 1, 0);
+            std::vector<FrozenGraph::vertex_descriptor> targets;
+            targets.reserve(num_edges(g));
+            for (vertex_descriptor v = 0; v != n; ++v) {
+                std::lock_guard<std::mutex> l(g.lock(v));
+                const adjacency_type&       a = g.adjacency(v);
+                for (std::size_t i = 0; i != a.size(); ++i)
+                    if (a[i] < n)
+                        targets.push_back(a[i]);
+                offsets[v + 1] = targets.size();}
+            return FrozenGraph(std::move(offsets), std::move(targets));}
+
+    public:
+        // ------------
+        // constructors
+        // ------------
+
+        /**
+         * default constructor
+         * creates empty graph
+         */
+        ConcurrentGraph () :
+                _locks        (new std::mutex[lock_count]),
+                _num_vertices (0),
+                _num_edges    (0) {
+            for (std::size_t k = 0; k != segment_count; ++k)
+                _segments[k].store(0);
+            assert(valid());}
+
+        ~ConcurrentGraph () {
+            for (std::size_t k = 0; k != segment_count; ++k)
+                delete [] _segments[k].load();}
+
+        ConcurrentGraph             (const ConcurrentGraph&) = delete;
+        ConcurrentGraph& operator = (const ConcurrentGraph&) = delete;
+    };
+
+// -----------
+// file format
+// -----------
+
+/**
+ * header of the binary format written by save and mapped by load
+ * followed by num_vertices + 1 offsets (uint64_t) and num_edges targets (int32_t)
+ * every field is in host byte order
+ */
+struct GraphFileHeader {
+    char          magic[8];
+    std::uint32_t version;
+    std::uint32_t reserved;
+    std::uint64_t num_vertices;
+    std::uint64_t num_edges;};
+
+static const char          graph_file_magic[8] = {'C', 'S', 'R', 'G', 'R', 'A', 'P', 'H'};
+static const std::uint32_t graph_file_version  = 1;
+
+// ----
+// save
+// ----
+
+/**
+ * @param const Graph& or const FrozenGraph&
+ * @param path of the file to write
+ * writes the graph in the binary format read by load
+ * throws runtime_error if the file cannot be written
+ */
+template <typename G>
+void save (const G& g, const std::string& path) {
+    typedef typename G::adjacency_iterator adjacency_iterator;
+
+    static_assert(sizeof(typename G::vertex_descriptor) == sizeof(std::int32_t), "targets are stored as int32_t");
+
+    GraphFileHeader h;
+    std::memcpy(h.magic, graph_file_magic, sizeof(h.magic));
+    h.version      = graph_file_version;
+    h.reserved     = 0;
+    h.num_vertices = num_vertices(g);
+    h.num_edges    = num_edges(g);
+
+    std::vector<FrozenGraph::offset_type> offsets(h.num_vertices + 1, 0);
+    for (std::uint64_t v = 0; v != h.num_vertices; ++v) {
+        std::pair<adjacency_iterator, adjacency_iterator> p = adjacent_vertices(v, g);
+        offsets[v + 1] = offsets[v] + std::distance(p.first, p.second);}
+
+    std::ofstream out(path.c_str(), std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(&h),             sizeof(h));
+    out.write(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(FrozenGraph::offset_type));
+    for (std::uint64_t v = 0; v != h.num_vertices; ++v) {
+        std::pair<adjacency_iterator, adjacency_iterator> p = adjacent_vertices(v, g);
+        if (p.first != p.second)
+            out.write(reinterpret_cast<const char*>(&*p.first), std::distance(p.first, p.second) * sizeof(std::int32_t));}
+    out.close();
+    if (!out)
+        throw std::runtime_error("save: cannot write " + path);}
+
+// ----
+// load
+// ----
+
+/**
+ * @param path of a file written by save
+ * maps the file read-only and points a FrozenGraph at it, no edge is copied
+ * processes loading the same file share its pages
+ * throws runtime_error if the file is missing, truncated, or its offsets are malformed
+ * checks only the offsets, O(V), so no target page is touched; call verify to check the targets
+ * @return FrozenGraph backed by the mapping
+ */
+inline FrozenGraph load (const std::string& path) {
+    typedef FrozenGraph::offset_type       offset_type;
+    typedef FrozenGraph::vertex_descriptor vertex_descriptor;
+
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd == -1)
+        throw std::runtime_error("load: cannot open " + path);
+    struct stat st;
+    if (fstat(fd, &st) == -1) {
+        close(fd);
+        throw std::runtime_error("load: cannot stat " + path);}
+    const std::uint64_t n = st.st_size;
+    if (n < sizeof(GraphFileHeader)) {
+        close(fd);
+        throw std::runtime_error("load: truncated header in " + path);}
+    void* p = mmap(0, n, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED)
+        throw std::runtime_error("load: cannot map " + path);
+    std::shared_ptr<FrozenGraph::mapping> m = std::make_shared<FrozenGraph::mapping>(p, n);
+
+    const char*            b = static_cast<const char*>(p);
+    const GraphFileHeader& h = *reinterpret_cast<const GraphFileHeader*>(b);
+    if (std::memcmp(h.magic, graph_file_magic, sizeof(h.magic)) != 0)
+        throw std::runtime_error("load: not a graph file " + path);
+    if (h.version != graph_file_version)
+        throw std::runtime_error("load: unsupported version in " + path);
+    if ((h.num_vertices >= (std::uint64_t) std::numeric_limits<vertex_descriptor>::max()) ||
+        (h.num_edges    >  (n - sizeof(h)) / sizeof(vertex_descriptor)) ||
+        (h.num_vertices >  (n - sizeof(h)) / sizeof(offset_type)))
+        throw std::runtime_error("load: truncated arrays in " + path);
+    const std::uint64_t s = sizeof(h) + (h.num_vertices + 1) * sizeof(offset_type) + h.num_edges * sizeof(vertex_descriptor);
+    if (n != s)
+        throw std::runtime_error(n < s ? "load: truncated arrays in " + path : "load: trailing bytes in " + path);
+
+    const offset_type*       offsets = reinterpret_cast<const offset_type*>(b + sizeof(h));
+    const vertex_descriptor* targets = reinterpret_cast<const vertex_descriptor*>(offsets + h.num_vertices + 1);
+    if (!FrozenGraph::valid_offsets(offsets, h.num_vertices, h.num_edges))
+        throw std::runtime_error("load: malformed arrays in " + path);
+
+    FrozenGraph g;
+    g.attach(m, offsets, targets, h.num_vertices);
+    return g;}
+
 #endif // Graph_h
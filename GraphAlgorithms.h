@@ -0,0 +1,693 @@
+// ------------------------------------
+// projects/c++/graph/GraphAlgorithms.h
+// Copyright (C) 2015
+// Glenn P. Downing
+// ------------------------------------
+
+#ifndef GraphAlgorithms_h
+#define GraphAlgorithms_h
+
+// --------
+// includes
+// --------
+
+#include <algorithm>          // max, min, reverse, sort, stable_sort, unique
+#include <atomic>             // atomic
+#include <cassert>            // assert
+#include <cstddef>            // size_t
+#include <cstdint>            // uint32_t, uint64_t
+#include <iterator>           // distance
+#include <memory>             // unique_ptr
+#include <numeric>            // iota
+#include <stdexcept>          // invalid_argument
+#include <utility>            // pair
+#include <vector>             // vector
+
+// the kernels use intrinsics inside target("avx2") functions, without -mavx2,
+// which <immintrin.h> allows only from gcc 5 and clang 4; older compilers get the scalar kernel
+#if ((defined(__clang__) && (__clang_major__ >= 4)) || (!defined(__clang__) && defined(__GNUC__) && (__GNUC__ >= 5))) && \
+    (defined(__x86_64__) || defined(__i386__))
+#define GRAPH_X86_KERNELS
+#include <immintrin.h>        // _mm_*, _mm256_*
+#endif
+
+#include "ThreadPool.h"
+
+// --------------------
+// breadth_first_levels
+// --------------------
+
+/**
+ * @param source vertex
+ * @param const graph, any type with num_vertices, num_edges, and adjacent_vertices
+ * @param pool to run on
+ * level-synchronous direction-optimizing breadth first search
+ * a level is expanded top-down from the frontier while the frontier's out-edges are few,
+ * and bottom-up from the unvisited vertices, checking their in-edges, once it grows large
+ * the source must be a vertex of g, unless g has none
+ * @return hop distance from the source for every vertex, -1 if unreachable, empty if g has no vertices
+ */
+template <typename G>
+std::vector<int> breadth_first_levels (typename G::vertex_descriptor s, const G& g, ThreadPool& pool = default_pool()) {
+    typedef typename G::vertex_descriptor  vertex_descriptor;
+    typedef typename G::adjacency_iterator adjacency_iterator;
+
+    const std::size_t n     = num_vertices(g);
+    if (n == 0)
+        return std::vector<int>();
+    assert((s >= 0) && (std::size_t(s) < n));
+    const std::size_t w     = pool.size();
+    const std::size_t alpha = 14;
+    const std::size_t beta  = 24;
+
+    std::unique_ptr<std::atomic<int>[]> levels(new std::atomic<int>[n]);
+    pool.parallel_for(0, n, 4096, [&] (std::size_t b, std::size_t e, std::size_t) {
+        for (std::size_t v = b; v != e; ++v)
+            levels[v].store(-1, std::memory_order_relaxed);});
+
+    std::vector<std::size_t> in_offsets;
+    std::vector<std::size_t> in_sources;
+
+    std::vector<std::size_t>              frontier(1, s);
+    std::vector<std::vector<std::size_t> > next(w);
+    std::vector<std::size_t>              edges_out(w);
+    std::size_t                           frontier_edges = 0;
+    std::size_t                           unvisited_edges = num_edges(g);
+    bool                                  bottom_up = false;
+    levels[s].store(0);
+    {
+    std::pair<adjacency_iterator, adjacency_iterator> p = adjacent_vertices(vertex_descriptor(s), g);
+    frontier_edges = std::distance(p.first, p.second);
+    }
+
+    for (int d = 0; !frontier.empty(); ++d) {
+        unvisited_edges -= std::min(unvisited_edges, frontier_edges);
+        if (!bottom_up && (frontier_edges > unvisited_edges / alpha))
+            bottom_up = true;
+        else if (bottom_up && (frontier.size() < n / beta))
+            bottom_up = false;
+
+        for (std::size_t i = 0; i != w; ++i) {
+            next[i].clear();
+            edges_out[i] = 0;}
+
+        if (!bottom_up)
+            pool.parallel_for(0, frontier.size(), 64, [&] (std::size_t b, std::size_t e, std::size_t k) {
+                for (std::size_t i = b; i != e; ++i) {
+                    std::pair<adjacency_iterator, adjacency_iterator> p = adjacent_vertices(vertex_descriptor(frontier[i]), g);
+                    for (; p.first != p.second; ++p.first) {
+                        const std::size_t v = *p.first;
+                        int               x = -1;
+                        if ((levels[v].load(std::memory_order_relaxed) == -1) && levels[v].compare_exchange_strong(x, d + 1)) {
+                            std::pair<adjacency_iterator, adjacency_iterator> q = adjacent_vertices(vertex_descriptor(v), g);
+                            edges_out[k] += std::distance(q.first, q.second);
+                            next[k].push_back(v);}}}});
+        else {
+            if (in_offsets.empty()) {
+                in_offsets.assign(n + 1, 0);
+                for (std::size_t u = 0; u != n; ++u) {
+                    std::pair<adjacency_iterator, adjacency_iterator> p = adjacent_vertices(vertex_descriptor(u), g);
+                    for (; p.first != p.second; ++p.first)
+                        ++in_offsets[*p.first + 1];}
+                for (std::size_t v = 1; v != in_offsets.size(); ++v)
+                    in_offsets[v] += in_offsets[v - 1];
+                in_sources.resize(in_offsets[n]);
+                std::vector<std::size_t> at(in_offsets.begin(), in_offsets.end() - 1);
+                for (std::size_t u = 0; u != n; ++u) {
+                    std::pair<adjacency_iterator, adjacency_iterator> p = adjacent_vertices(vertex_descriptor(u), g);
+                    for (; p.first != p.second; ++p.first)
+                        in_sources[at[*p.first]++] = u;}}
+
+            pool.parallel_for(0, n, 1024, [&] (std::size_t b, std::size_t e, std::size_t k) {
+                for (std::size_t v = b; v != e; ++v) {
+                    if (levels[v].load(std::memory_order_relaxed) != -1)
+                        continue;
+                    for (std::size_t i = in_offsets[v]; i != in_offsets[v + 1]; ++i) {
+                        if (levels[in_sources[i]].load(std::memory_order_relaxed) == d) {
+                            levels[v].store(d + 1, std::memory_order_relaxed);
+                            std::pair<adjacency_iterator, adjacency_iterator> q = adjacent_vertices(vertex_descriptor(v), g);
+                            edges_out[k] += std::distance(q.first, q.second);
+                            next[k].push_back(v);
+                            break;}}}});}
+
+        frontier.clear();
+        frontier_edges = 0;
+        for (std::size_t i = 0; i != w; ++i) {
+            frontier.insert(frontier.end(), next[i].begin(), next[i].end());
+            frontier_edges += edges_out[i];}}
+
+    std::vector<int> r(n);
+    for (std::size_t v = 0; v != n; ++v)
+        r[v] = levels[v].load(std::memory_order_relaxed);
+    return r;}
+
+// -----------------
+// topological_order
+// -----------------
+
+/**
+ * @param const graph, any type with num_vertices and adjacent_vertices
+ * @param pool to run on
+ * parallel Kahn's algorithm: in-degrees are atomic counters, and each round releases
+ * every vertex whose last incoming edge came from the previous round
+ * throws invalid_argument if the graph has a cycle
+ * @return every vertex, each before all of its adjacent vertices
+ */
+template <typename G>
+std::vector<typename G::vertex_descriptor> topological_order (const G& g, ThreadPool& pool = default_pool()) {
+    typedef typename G::vertex_descriptor  vertex_descriptor;
+    typedef typename G::adjacency_iterator adjacency_iterator;
+
+    const std::size_t n = num_vertices(g);
+    const std::size_t w = pool.size();
+
+    std::unique_ptr<std::atomic<std::size_t>[]> in_degrees(new std::atomic<std::size_t>[n]);
+    pool.parallel_for(0, n, 4096, [&] (std::size_t b, std::size_t e, std::size_t) {
+        for (std::size_t v = b; v != e; ++v)
+            in_degrees[v].store(0, std::memory_order_relaxed);});
+    pool.parallel_for(0, n, 1024, [&] (std::size_t b, std::size_t e, std::size_t) {
+        for (std::size_t u = b; u != e; ++u) {
+            std::pair<adjacency_iterator, adjacency_iterator> p = adjacent_vertices(vertex_descriptor(u), g);
+            for (; p.first != p.second; ++p.first)
+                in_degrees[*p.first].fetch_add(1, std::memory_order_relaxed);}});
+
+    std::vector<std::vector<vertex_descriptor> > next(w);
+    pool.parallel_for(0, n, 4096, [&] (std::size_t b, std::size_t e, std::size_t k) {
+        for (std::size_t v = b; v != e; ++v)
+            if (in_degrees[v].load(std::memory_order_relaxed) == 0)
+                next[k].push_back(vertex_descriptor(v));});
+
+    std::vector<vertex_descriptor> order;
+    order.reserve(n);
+    while (true) {
+        const std::size_t b = order.size();
+        for (std::size_t i = 0; i != w; ++i) {
+            order.insert(order.end(), next[i].begin(), next[i].end());
+            next[i].clear();}
+        if (b == order.size())
+            break;
+        pool.parallel_for(b, order.size(), 64, [&] (std::size_t i, std::size_t j, std::size_t k) {
+            for (; i != j; ++i) {
+                std::pair<adjacency_iterator, adjacency_iterator> p = adjacent_vertices(order[i], g);
+                for (; p.first != p.second; ++p.first)
+                    if (in_degrees[*p.first].fetch_sub(1, std::memory_order_acq_rel) == 1)
+                        next[k].push_back(*p.first);}});}
+
+    if (order.size() != n)
+        throw std::invalid_argument("topological_order: graph has a cycle");
+    return order;}
+
+// ----------------
+// intersect_sorted
+// ----------------
+
+/**
+ * kernels for intersecting two sorted, duplicate-free vertex arrays
+ * sse2 and avx2 compare a block of 4 or 8 from each array all-against-all with
+ * rotated copies, then advance whichever block ends lower
+ */
+enum intersect_kernel {
+    scalar_kernel,
+    sse2_kernel,
+    avx2_kernel};
+
+/**
+ * @param kernel
+ * @return true if the kernel was compiled in and the processor runs it
+ */
+inline bool kernel_supported (intersect_kernel k) {
+    if (k == scalar_kernel)
+        return true;
+    #ifdef GRAPH_X86_KERNELS
+    __builtin_cpu_init();
+    if (k == sse2_kernel)
+        return __builtin_cpu_supports("sse2");
+    if (k == avx2_kernel)
+        return __builtin_cpu_supports("avx2");
+    #endif
+    return false;}
+
+/**
+ * @return the widest supported kernel, probed once
+ */
+inline intersect_kernel best_kernel () {
+    static const intersect_kernel k = kernel_supported(avx2_kernel) ? avx2_kernel :
+                                      kernel_supported(sse2_kernel) ? sse2_kernel :
+                                                                      scalar_kernel;
+    return k;}
+
+namespace graph_detail {
+
+/**
+ * merge the tails a[i, na) and b[j, nb), appending matches to out if it is not null
+ */
+inline std::size_t intersect_scalar (const int* a, std::size_t i, std::size_t na, const int* b, std::size_t j, std::size_t nb, int* out, std::size_t n) {
+    while ((i != na) && (j != nb)) {
+        if (a[i] < b[j])
+            ++i;
+        else if (b[j] < a[i])
+            ++j;
+        else {
+            if (out != 0)
+                out[n] = a[i];
+            ++n;
+            ++i;
+            ++j;}}
+    return n;}
+
+#ifdef GRAPH_X86_KERNELS
+
+__attribute__((target("sse2")))
+inline std::size_t intersect_sse2 (const int* a, std::size_t na, const int* b, std::size_t nb, int* out) {
+    std::size_t i = 0;
+    std::size_t j = 0;
+    std::size_t n = 0;
+    while ((i + 4 <= na) && (j + 4 <= nb)) {
+        const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + j));
+        __m128i m = _mm_cmpeq_epi32(va, vb);
+        m = _mm_or_si128(m, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1))));
+        m = _mm_or_si128(m, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2))));
+        m = _mm_or_si128(m, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3))));
+        int mask = _mm_movemask_ps(_mm_castsi128_ps(m));
+        if (out == 0)
+            n += __builtin_popcount(mask);
+        else
+            for (std::size_t k = 0; mask != 0; ++k, mask >>= 1)
+                if (mask & 1)
+                    out[n++] = a[i + k];
+        const int amax = a[i + 3];
+        const int bmax = b[j + 3];
+        if (amax <= bmax)
+            i += 4;
+        if (bmax <= amax)
+            j += 4;}
+    return intersect_scalar(a, i, na, b, j, nb, out, n);}
+
+__attribute__((target("avx2")))
+inline std::size_t intersect_avx2 (const int* a, std::size_t na, const int* b, std::size_t nb, int* out) {
+    std::size_t i = 0;
+    std::size_t j = 0;
+    std::size_t n = 0;
+    const __m256i r1 = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+    while ((i + 8 <= na) && (j + 8 <= nb)) {
+        const __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        __m256i       vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + j));
+        __m256i       m  = _mm256_cmpeq_epi32(va, vb);
+        for (int r = 1; r != 8; ++r) {
+            vb = _mm256_permutevar8x32_epi32(vb, r1);
+            m  = _mm256_or_si256(m, _mm256_cmpeq_epi32(va, vb));}
+        int mask = _mm256_movemask_ps(_mm256_castsi256_ps(m));
+        if (out == 0)
+            n += __builtin_popcount(mask);
+        else
+            for (std::size_t k = 0; mask != 0; ++k, mask >>= 1)
+                if (mask & 1)
+                    out[n++] = a[i + k];
+        const int amax = a[i + 7];
+        const int bmax = b[j + 7];
+        if (amax <= bmax)
+            i += 8;
+        if (bmax <= amax)
+            j += 8;}
+    return intersect_scalar(a, i, na, b, j, nb, out, n);}
+
+#endif
+
+}
+
+/**
+ * @param sorted, duplicate-free array and its size
+ * @param sorted, duplicate-free array and its size
+ * @param where to write the common elements in order, room for min(na, nb), or null to only count
+ * @param kernel, must be supported
+ * @return number of common elements
+ */
+inline std::size_t intersect_sorted (const int* a, std::size_t na, const int* b, std::size_t nb, int* out, intersect_kernel k = best_kernel()) {
+    assert(kernel_supported(k));
+    #ifdef GRAPH_X86_KERNELS
+    if (k == avx2_kernel)
+        return graph_detail::intersect_avx2(a, na, b, nb, out);
+    if (k == sse2_kernel)
+        return graph_detail::intersect_sse2(a, na, b, nb, out);
+    #endif
+    return graph_detail::intersect_scalar(a, 0, na, b, 0, nb, out, 0);}
+
+// ----------------
+// common_neighbors
+// ----------------
+
+/**
+ * @param 2 vertex descriptors
+ * @param const graph whose adjacencies are sorted contiguous arrays (Graph, ArenaGraph, FrozenGraph)
+ * @return the vertices adjacent to both, in order
+ */
+template <typename G>
+std::vector<typename G::vertex_descriptor> common_neighbors (typename G::vertex_descriptor u, typename G::vertex_descriptor v, const G& g) {
+    typedef typename G::vertex_descriptor  vertex_descriptor;
+    typedef typename G::adjacency_iterator adjacency_iterator;
+
+    std::pair<adjacency_iterator, adjacency_iterator> p = adjacent_vertices(u, g);
+    std::pair<adjacency_iterator, adjacency_iterator> q = adjacent_vertices(v, g);
+    const std::size_t na = std::distance(p.first, p.second);
+    const std::size_t nb = std::distance(q.first, q.second);
+    std::vector<vertex_descriptor> r(std::min(na, nb));
+    if (!r.empty())
+        r.resize(intersect_sorted(&*p.first, na, &*q.first, nb, &r[0]));
+    return r;}
+
+namespace graph_detail {
+
+/**
+ * the undirected view of a graph, without self loops, in CSR form
+ * each list is sorted by id and holds every neighbour once
+ */
+struct undirected_graph {
+    std::vector<std::size_t> offsets;
+    std::vector<int>         targets;
+
+    const int* begin (std::size_t v) const {
+        return targets.data() + offsets[v];}
+
+    std::size_t size (std::size_t v) const {
+        return offsets[v + 1] - offsets[v];}};
+
+template <typename G>
+undirected_graph symmetrize (const G& g, ThreadPool& pool) {
+    typedef typename G::vertex_descriptor  vertex_descriptor;
+    typedef typename G::adjacency_iterator adjacency_iterator;
+
+    const std::size_t n = num_vertices(g);
+
+    undirected_graph u;
+    u.offsets.assign(n + 1, 0);
+    for (std::size_t v = 0; v != n; ++v) {
+        std::pair<adjacency_iterator, adjacency_iterator> p = adjacent_vertices(vertex_descriptor(v), g);
+        for (; p.first != p.second; ++p.first)
+            if (std::size_t(*p.first) != v) {
+                ++u.offsets[v + 1];
+                ++u.offsets[*p.first + 1];}}
+    for (std::size_t v = 1; v <= n; ++v)
+        u.offsets[v] += u.offsets[v - 1];
+    u.targets.resize(u.offsets[n]);
+    std::vector<std::size_t> at(u.offsets.begin(), u.offsets.end() - 1);
+    for (std::size_t v = 0; v != n; ++v) {
+        std::pair<adjacency_iterator, adjacency_iterator> p = adjacent_vertices(vertex_descriptor(v), g);
+        for (; p.first != p.second; ++p.first)
+            if (std::size_t(*p.first) != v) {
+                u.targets[at[v]++]        = *p.first;
+                u.targets[at[*p.first]++] = v;}}
+
+    std::vector<std::size_t> degrees(n);
+    pool.parallel_for(0, n, 256, [&] (std::size_t b, std::size_t e, std::size_t) {
+        for (std::size_t v = b; v != e; ++v) {
+            std::vector<int>::iterator tb = u.targets.begin() + u.offsets[v];
+            std::vector<int>::iterator te = u.targets.begin() + u.offsets[v + 1];
+            std::sort(tb, te);
+            degrees[v] = std::unique(tb, te) - tb;}});
+
+    std::size_t k = 0;
+    for (std::size_t v = 0; v != n; ++v) {
+        const std::size_t b = u.offsets[v];
+        u.offsets[v] = k;
+        for (std::size_t i = 0; i != degrees[v]; ++i)
+            u.targets[k++] = u.targets[b + i];}
+    u.offsets[n] = k;
+    u.targets.resize(k);
+    return u;}
+
+/**
+ * the undirected view of a graph, without self loops, in CSR form
+ * each undirected edge is kept once, at whichever endpoint comes first by (degree, id),
+ * which bounds every kept list by about sqrt(2 E) on skewed graphs
+ * lists stay sorted by id
+ */
+struct oriented_graph {
+    std::vector<std::size_t> offsets;
+    std::vector<int>         targets;
+    std::vector<std::size_t> degrees;
+
+    const int* begin (std::size_t v) const {
+        return targets.data() + offsets[v];}
+
+    std::size_t size (std::size_t v) const {
+        return offsets[v + 1] - offsets[v];}};
+
+template <typename G>
+oriented_graph orient (const G& g, ThreadPool& pool) {
+    const undirected_graph u = symmetrize(g, pool);
+    const std::size_t      n = u.offsets.size() - 1;
+
+    oriented_graph o;
+    o.degrees.resize(n);
+    for (std::size_t v = 0; v != n; ++v)
+        o.degrees[v] = u.size(v);
+
+    const std::vector<std::size_t>& d = o.degrees;
+    o.offsets.assign(n + 1, 0);
+    for (std::size_t v = 0; v != n; ++v) {
+        std::size_t k = 0;
+        for (const int* w = u.begin(v); w != u.begin(v) + u.size(v); ++w)
+            k += (d[v] < d[*w]) || ((d[v] == d[*w]) && (v < std::size_t(*w)));
+        o.offsets[v + 1] = o.offsets[v] + k;}
+    o.targets.resize(o.offsets[n]);
+    pool.parallel_for(0, n, 1024, [&] (std::size_t b, std::size_t e, std::size_t) {
+        for (std::size_t v = b; v != e; ++v) {
+            std::size_t k = o.offsets[v];
+            for (const int* w = u.begin(v); w != u.begin(v) + u.size(v); ++w)
+                if ((d[v] < d[*w]) || ((d[v] == d[*w]) && (v < std::size_t(*w))))
+                    o.targets[k++] = *w;}});
+    return o;}
+
+}
+
+// ---------------
+// count_triangles
+// ---------------
+
+/**
+ * @param const graph, any type with num_vertices and adjacent_vertices
+ * @param pool to run on
+ * @param intersection kernel, must be supported
+ * counts triangles of the undirected view: edge direction and self loops are ignored
+ * each edge's two oriented lists are intersected, split across the pool
+ * @return number of triangles
+ */
+template <typename G>
+std::uint64_t count_triangles (const G& g, ThreadPool& pool = default_pool(), intersect_kernel k = best_kernel()) {
+    const graph_detail::oriented_graph o = graph_detail::orient(g, pool);
+    const std::size_t                  n = o.degrees.size();
+
+    std::vector<std::uint64_t> counts(pool.size(), 0);
+    pool.parallel_for(0, n, 64, [&] (std::size_t b, std::size_t e, std::size_t w) {
+        std::uint64_t c = 0;
+        for (std::size_t u = b; u != e; ++u)
+            for (const int* v = o.begin(u); v != o.begin(u) + o.size(u); ++v)
+                c += intersect_sorted(o.begin(u), o.size(u), o.begin(*v), o.size(*v), 0, k);
+        counts[w] += c;});
+
+    std::uint64_t c = 0;
+    for (std::size_t w = 0; w != counts.size(); ++w)
+        c += counts[w];
+    return c;}
+
+// -----------------------------
+// local_clustering_coefficients
+// -----------------------------
+
+/**
+ * @param const graph, any type with num_vertices and adjacent_vertices
+ * @param pool to run on
+ * @param intersection kernel, must be supported
+ * local clustering of the undirected view: edge direction and self loops are ignored
+ * @return for every vertex, triangles through it over d (d - 1) / 2, or 0 when its degree d is below 2
+ */
+template <typename G>
+std::vector<double> local_clustering_coefficients (const G& g, ThreadPool& pool = default_pool(), intersect_kernel k = best_kernel()) {
+    const graph_detail::oriented_graph o = graph_detail::orient(g, pool);
+    const std::size_t                  n = o.degrees.size();
+
+    std::unique_ptr<std::atomic<std::uint64_t>[]> t(new std::atomic<std::uint64_t>[n]);
+    for (std::size_t v = 0; v != n; ++v)
+        t[v].store(0, std::memory_order_relaxed);
+
+    std::vector<std::vector<int> > buffers(pool.size());
+    pool.parallel_for(0, n, 64, [&] (std::size_t b, std::size_t e, std::size_t w) {
+        std::vector<int>& x = buffers[w];
+        for (std::size_t u = b; u != e; ++u)
+            for (const int* v = o.begin(u); v != o.begin(u) + o.size(u); ++v) {
+                x.resize(std::max(x.size(), std::min(o.size(u), o.size(*v))));
+                if (x.empty())
+                    continue;
+                const std::size_t c = intersect_sorted(o.begin(u), o.size(u), o.begin(*v), o.size(*v), &x[0], k);
+                if (c == 0)
+                    continue;
+                t[u].fetch_add(c, std::memory_order_relaxed);
+                t[*v].fetch_add(c, std::memory_order_relaxed);
+                for (std::size_t i = 0; i != c; ++i)
+                    t[x[i]].fetch_add(1, std::memory_order_relaxed);}});
+
+    std::vector<double> r(n, 0);
+    for (std::size_t v = 0; v != n; ++v) {
+        const double d = o.degrees[v];
+        if (d >= 2)
+            r[v] = t[v].load(std::memory_order_relaxed) / (d * (d - 1) / 2);}
+    return r;}
+
+// -------------------
+// inverse_permutation
+// -------------------
+
+/**
+ * @param permutation of [0, n)
+ * @return the permutation q with q[p[v]] == v, e.g. new-to-old ids from an old-to-new mapping
+ */
+inline std::vector<int> inverse_permutation (const std::vector<int>& p) {
+    std::vector<int> q(p.size());
+    for (std::size_t v = 0; v != p.size(); ++v)
+        q[p[v]] = v;
+    return q;}
+
+namespace graph_detail {
+
+/**
+ * @param undirected view
+ * @param the vertices to start a new component from, tried in order
+ * @param whether each vertex's newly reached neighbours are queued by increasing degree, or by id
+ * @return the vertices in order of discovery, every component in turn
+ */
+inline std::vector<int> breadth_first_order (const undirected_graph& u, const std::vector<int>& starts, bool by_degree) {
+    const std::size_t n = u.offsets.size() - 1;
+
+    std::vector<int>  order;
+    std::vector<bool> seen(n, false);
+    order.reserve(n);
+    for (std::size_t i = 0; i != starts.size(); ++i) {
+        if (seen[starts[i]])
+            continue;
+        seen[starts[i]] = true;
+        order.push_back(starts[i]);
+        for (std::size_t h = order.size() - 1; h != order.size(); ++h) {
+            const int         v = order[h];
+            const std::size_t b = order.size();
+            for (const int* w = u.begin(v); w != u.begin(v) + u.size(v); ++w)
+                if (!seen[*w]) {
+                    seen[*w] = true;
+                    order.push_back(*w);}
+            if (by_degree)
+                std::stable_sort(order.begin() + b, order.end(), [&] (int x, int y) {
+                    return u.size(x) < u.size(y);});}}
+    return order;}
+
+
+}
+
+// ------------
+// degree_order
+// ------------
+
+/**
+ * @param const graph, any type with num_vertices and adjacent_vertices
+ * numbers the vertices by decreasing in-degree plus out-degree, ties by id,
+ * which packs the hubs that most edges point at into the first few cache lines
+ * @return old-to-new mapping
+ */
+template <typename G>
+std::vector<typename G::vertex_descriptor> degree_order (const G& g) {
+    typedef typename G::vertex_descriptor  vertex_descriptor;
+    typedef typename G::adjacency_iterator adjacency_iterator;
+
+    const std::size_t n = num_vertices(g);
+
+    std::vector<std::size_t> d(n, 0);
+    for (std::size_t v = 0; v != n; ++v) {
+        std::pair<adjacency_iterator, adjacency_iterator> p = adjacent_vertices(vertex_descriptor(v), g);
+        for (; p.first != p.second; ++p.first) {
+            ++d[v];
+            ++d[*p.first];}}
+
+    std::vector<int> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&] (int x, int y) {
+        return d[x] > d[y];});
+    return inverse_permutation(order);}
+
+// -------------------
+// cuthill_mckee_order
+// -------------------
+
+/**
+ * @param const graph, any type with num_vertices and adjacent_vertices
+ * @param pool to run on
+ * reverse Cuthill-McKee on the undirected view: breadth first from a least-degree vertex of each
+ * component, queueing neighbours by increasing degree, then reversed
+ * keeps every edge's endpoints close, so a vertex's neighbours share cache lines and pages
+ * @return old-to-new mapping
+ */
+template <typename G>
+std::vector<typename G::vertex_descriptor> cuthill_mckee_order (const G& g, ThreadPool& pool = default_pool()) {
+    const graph_detail::undirected_graph u = graph_detail::symmetrize(g, pool);
+    const std::size_t                    n = u.offsets.size() - 1;
+
+    std::vector<int> starts(n);
+    std::iota(starts.begin(), starts.end(), 0);
+    std::stable_sort(starts.begin(), starts.end(), [&] (int x, int y) {
+        return u.size(x) < u.size(y);});
+
+    std::vector<int> order = graph_detail::breadth_first_order(u, starts, true);
+    std::reverse(order.begin(), order.end());
+    return inverse_permutation(order);}
+
+// ---------
+// bfs_order
+// ---------
+
+/**
+ * @param const graph, any type with num_vertices and adjacent_vertices
+ * @param pool to run on
+ * breadth first on the undirected view from a greatest-degree vertex of each component
+ * vertices discovered together, as a traversal will visit them, get consecutive ids
+ * @return old-to-new mapping
+ */
+template <typename G>
+std::vector<typename G::vertex_descriptor> bfs_order (const G& g, ThreadPool& pool = default_pool()) {
+    const graph_detail::undirected_graph u = graph_detail::symmetrize(g, pool);
+    const std::size_t                    n = u.offsets.size() - 1;
+
+    std::vector<int> starts(n);
+    std::iota(starts.begin(), starts.end(), 0);
+    std::stable_sort(starts.begin(), starts.end(), [&] (int x, int y) {
+        return u.size(x) > u.size(y);});
+
+    return inverse_permutation(graph_detail::breadth_first_order(u, starts, false));}
+
+// -------
+// reorder
+// -------
+
+enum vertex_ordering {
+    degree_ordering,
+    cuthill_mckee_ordering,
+    bfs_ordering};
+
+/**
+ * @param graph with relabel (Graph, ArenaGraph)
+ * @param ordering
+ * @param pool to run on
+ * relabels the graph once, typically right after loading, so that traversals touch nearby memory
+ * vertex descriptors held from before must be translated: new = p[old], old = inverse_permutation(p)[new]
+ * @return old-to-new mapping p
+ */
+template <typename G>
+std::vector<typename G::vertex_descriptor> reorder (G& g, vertex_ordering o = degree_ordering, ThreadPool& pool = default_pool()) {
+    std::vector<typename G::vertex_descriptor> p;
+    if (o == degree_ordering)
+        p = degree_order(g);
+    else if (o == cuthill_mckee_ordering)
+        p = cuthill_mckee_order(g, pool);
+    else
+        p = bfs_order(g, pool);
+    relabel(p, g);
+    return p;}
+
+#endif // GraphAlgorithms_h
@@ -8,17 +8,32 @@
 // includes
 // --------
 
-#include <iostream> // cout, endl
-#include <iterator> // ostream_iterator
-#include <sstream>  // ostringstream
-#include <utility>  // pair
+#include <algorithm> // equal, random_shuffle, set_intersection, sort
+#include <atomic>    // atomic
+#include <cstdint>   // int32_t
+#include <cstdio>    // remove
+#include <cstdlib>   // abs
+#include <fstream>   // fstream
+#include <iostream>  // cout, endl
+#include <iterator>  // back_inserter, ostream_iterator
+#include <list>      // list
+#include <set>       // set
+#include <sstream>   // ostringstream
+#include <stdexcept> // invalid_argument, runtime_error
+#include <thread>    // thread
+#include <utility>   // pair
+#include <vector>    // vector
 
 #include "boost/graph/adjacency_list.hpp"  // adjacency_list
+#include "boost/graph/breadth_first_search.hpp" // breadth_first_search
 #include "boost/graph/topological_sort.hpp"// topological_sort
 
 #include "gtest/gtest.h"
 
+#include <unistd.h> // truncate
+
 #include "Graph.h"
+#include "GraphAlgorithms.h"
 
 using namespace std;
 
@@ -49,7 +64,8 @@ struct TestGraph : Test {
 // possibly cyclic
 typedef Types<
             boost::adjacency_list<boost::setS, boost::vecS, boost::directedS>,
-            Graph>
+            Graph,
+            ArenaGraph>
         graph_types;
 
 TYPED_TEST_CASE(TestGraph, graph_types);
@@ -1319,4 +1335,1086 @@ TYPED_TEST(TestGraph, edges1) {
 
 
 
-    ASSERT_EQ(8, num_vertices(g));}
\ No newline at end of file
+    ASSERT_EQ(8, num_vertices(g));}
+
+    TYPED_TEST(TestGraph, edges4) {
+    typedef typename TestFixture::graph_type         graph_type;
+    typedef typename TestFixture::vertex_descriptor  vertex_descriptor;
+    typedef typename TestFixture::edge_descriptor    edge_descriptor;
+
+    typedef typename TestFixture::edge_iterator      edge_iterator;
+    typedef typename TestFixture::adjacency_iterator adjacency_iterator;
+
+    graph_type g;
+
+    vertex_descriptor vdA = add_vertex(g);
+    vertex_descriptor vdB = add_vertex(g);
+    vertex_descriptor vdC = add_vertex(g);
+    vertex_descriptor vdD = add_vertex(g);
+
+    add_edge(vdA, vdD, g);
+    add_edge(vdA, vdB, g);
+    add_edge(vdD, vdC, g);
+    add_edge(vdA, vdC, g);
+    ASSERT_EQ(false, add_edge(vdA, vdB, g).second);
+
+    pair<adjacency_iterator, adjacency_iterator> q = adjacent_vertices(vdA, g);
+    ASSERT_EQ(3, distance(q.first, q.second));
+    ASSERT_EQ(vdB, *q.first++);
+    ASSERT_EQ(vdC, *q.first++);
+    ASSERT_EQ(vdD, *q.first++);
+
+    pair<edge_iterator, edge_iterator> p = edges(g);
+    edge_iterator                      b = p.first;
+    edge_iterator                      e = p.second;
+    edge_descriptor                    ed;
+    ed = *b++;
+    ASSERT_EQ(vdA, source(ed, g));
+    ASSERT_EQ(vdB, target(ed, g));
+    ed = *b++;
+    ASSERT_EQ(vdA, source(ed, g));
+    ASSERT_EQ(vdC, target(ed, g));
+    ed = *b++;
+    ASSERT_EQ(vdA, source(ed, g));
+    ASSERT_EQ(vdD, target(ed, g));
+    ed = *b++;
+    ASSERT_EQ(vdD, source(ed, g));
+    ASSERT_EQ(vdC, target(ed, g));
+    ASSERT_EQ(e, b);
+    ASSERT_EQ(4, num_edges(g));}
+
+
+// ------------
+// TestAddEdges
+// ------------
+
+TEST(TestAddEdges, add_edges1) {
+    Graph g;
+
+    vector<Graph::edge_descriptor> v;
+
+    ASSERT_EQ(0, add_edges(v.begin(), v.end(), g));
+    ASSERT_EQ(0, num_vertices(g));
+    ASSERT_EQ(0, num_edges(g));}
+
+TEST(TestAddEdges, add_edges2) {
+    Graph g;
+
+    vector<Graph::edge_descriptor> v;
+    v.push_back(make_pair(2, 0));
+    v.push_back(make_pair(0, 3));
+    v.push_back(make_pair(0, 1));
+    v.push_back(make_pair(2, 0));
+    v.push_back(make_pair(0, 3));
+
+    ASSERT_EQ(3, add_edges(v.begin(), v.end(), g));
+    ASSERT_EQ(4, num_vertices(g));
+    ASSERT_EQ(3, num_edges(g));
+
+    pair<Graph::adjacency_iterator, Graph::adjacency_iterator> p = adjacent_vertices(0, g);
+    ASSERT_EQ(2, distance(p.first, p.second));
+    ASSERT_EQ(1, p.first[0]);
+    ASSERT_EQ(3, p.first[1]);
+    ASSERT_TRUE(edge(2, 0, g).second);}
+
+TEST(TestAddEdges, add_edges3) {
+    Graph g;
+
+    add_edge(0, 2, g);
+    add_edge(1, 0, g);
+
+    vector<Graph::edge_descriptor> v;
+    v.push_back(make_pair(0, 1));
+    v.push_back(make_pair(0, 2));
+    v.push_back(make_pair(5, 5));
+
+    ASSERT_EQ(2, add_edges(v.begin(), v.end(), g));
+    ASSERT_EQ(6, num_vertices(g));
+    ASSERT_EQ(4, num_edges(g));
+
+    pair<Graph::adjacency_iterator, Graph::adjacency_iterator> p = adjacent_vertices(0, g);
+    ASSERT_EQ(2, distance(p.first, p.second));
+    ASSERT_EQ(1, p.first[0]);
+    ASSERT_EQ(2, p.first[1]);
+    ASSERT_TRUE(edge(5, 5, g).second);}
+
+TEST(TestAddEdges, add_edges4) {
+    Graph g1;
+    vector<Graph::edge_descriptor> v;
+    for (int i = 0; i != 500; ++i) {
+        Graph::edge_descriptor ed = make_pair((i * 7919) % 61, (i * 104729) % 53);
+        add_edge(ed.first, ed.second, g1);
+        v.push_back(ed);}
+
+    Graph g2(v.begin(), v.end());
+
+    ASSERT_EQ(num_vertices(g1), num_vertices(g2));
+    ASSERT_EQ(num_edges(g1),    num_edges(g2));
+    ASSERT_TRUE(equal(edges(g1).first, edges(g1).second, edges(g2).first));}
+
+TEST(TestAddEdges, add_edges5) {
+    Graph                          g1;
+    Graph                          g2;
+    vector<Graph::edge_descriptor> v;
+    unsigned                       x = 378;
+    for (int i = 0; i != 40000; ++i) {
+        x = x * 1103515245 + 12345;
+        const int a = (x >> 8) % 5000;
+        x = x * 1103515245 + 12345;
+        const int b = (x >> 8) % ((i % 3 == 0) ? 7 : 5000);
+        add_edge(a, b, g1);
+        v.push_back(make_pair(a, b));}
+
+    ThreadPool p(4);
+    const Graph::edges_size_type k = add_edges(v.begin() + 100, v.end(), g2, p);
+    ASSERT_EQ(k, num_edges(g2));
+    list<Graph::edge_descriptor> l(v.begin(), v.end());
+    ASSERT_EQ(num_edges(g1) - k, add_edges(l.begin(), l.end(), g2, p));
+
+    ASSERT_EQ(num_vertices(g1), num_vertices(g2));
+    ASSERT_EQ(num_edges(g1),    num_edges(g2));
+    ASSERT_TRUE(equal(edges(g1).first, edges(g1).second, edges(g2).first));}
+
+
+// ---------------
+// TestFrozenGraph
+// ---------------
+
+TEST(TestFrozenGraph, freeze1) {
+    Graph g;
+
+    FrozenGraph f = freeze(g);
+
+    ASSERT_EQ(0, num_vertices(f));
+    ASSERT_EQ(0, num_edges(f));
+    ASSERT_TRUE(edges(f).first == edges(f).second);}
+
+TEST(TestFrozenGraph, freeze2) {
+    Graph g;
+
+    Graph::vertex_descriptor vdA = add_vertex(g);
+    Graph::vertex_descriptor vdB = add_vertex(g);
+    Graph::vertex_descriptor vdC = add_vertex(g);
+
+    add_edge(vdA, vdC, g);
+    add_edge(vdA, vdB, g);
+    add_edge(vdC, vdA, g);
+
+    FrozenGraph f = freeze(g);
+    add_edge(vdB, vdA, g);
+
+    ASSERT_EQ(3, num_vertices(f));
+    ASSERT_EQ(3, num_edges(f));
+    ASSERT_TRUE (edge(vdA, vdB, f).second);
+    ASSERT_TRUE (edge(vdC, vdA, f).second);
+    ASSERT_FALSE(edge(vdB, vdA, f).second);
+    ASSERT_FALSE(edge(7,   vdA, f).second);
+    ASSERT_EQ(vdC, source(make_pair(vdC, vdA), f));
+    ASSERT_EQ(vdA, target(make_pair(vdC, vdA), f));
+    ASSERT_EQ(-1,  source(make_pair(vdB, vdC), f));}
+
+TEST(TestFrozenGraph, adjacent_vertices1) {
+    Graph g;
+
+    Graph::vertex_descriptor vdA = add_vertex(g);
+    Graph::vertex_descriptor vdB = add_vertex(g);
+    Graph::vertex_descriptor vdC = add_vertex(g);
+    Graph::vertex_descriptor vdD = add_vertex(g);
+
+    add_edge(vdA, vdD, g);
+    add_edge(vdA, vdB, g);
+    add_edge(vdC, vdA, g);
+
+    FrozenGraph f = freeze(g);
+
+    pair<FrozenGraph::adjacency_iterator, FrozenGraph::adjacency_iterator> p = adjacent_vertices(vdA, f);
+    ASSERT_EQ(2,   p.second - p.first);
+    ASSERT_EQ(vdB, p.first[0]);
+    ASSERT_EQ(vdD, p.first[1]);
+
+    p = adjacent_vertices(vdB, f);
+    ASSERT_EQ(p.first, p.second);
+
+    p = adjacent_vertices(vdC, f);
+    ASSERT_EQ(1,   p.second - p.first);
+    ASSERT_EQ(vdA, *p.first);}
+
+TEST(TestFrozenGraph, edges1) {
+    Graph g;
+
+    for (int i = 0; i != 6; ++i)
+        add_vertex(g);
+
+    add_edge(4, 0, g);
+    add_edge(0, 2, g);
+    add_edge(2, 0, g);
+    add_edge(0, 1, g);
+    add_edge(1, 3, g);
+    add_edge(1, 0, g);
+
+    FrozenGraph f = freeze(g);
+
+    ASSERT_TRUE(equal(edges(g).first, edges(g).second, edges(f).first));
+
+    FrozenGraph::edges_size_type n = 0;
+    for (FrozenGraph::edge_iterator b = edges(f).first; b != edges(f).second; ++b)
+        ++n;
+    ASSERT_EQ(num_edges(g), n);}
+
+TEST(TestFrozenGraph, vertices1) {
+    Graph g;
+
+    add_edge(3, 1, g);
+
+    FrozenGraph f = freeze(g);
+
+    ASSERT_EQ(4, num_vertices(f));
+    ASSERT_TRUE(equal(vertices(g).first, vertices(g).second, vertices(f).first));
+    ASSERT_EQ(2, vertex(2, f));}
+
+TEST(TestFrozenGraph, vertices2) {
+    Graph g;
+
+    add_edge(5, 2, g);
+
+    const FrozenGraph f = freeze(g);
+    const FrozenGraph h = f;
+
+    pair<FrozenGraph::vertex_iterator, FrozenGraph::vertex_iterator> p = vertices(h);
+    ASSERT_EQ(6, p.second - p.first);
+    ASSERT_EQ(0, *p.first);
+    ASSERT_EQ(5, *--p.second);
+    ASSERT_EQ(3, p.first[3]);
+    ASSERT_EQ(4, *(p.first + 4));
+    ASSERT_TRUE(p.first < p.second);
+    ASSERT_TRUE(p.first + 5 == p.second);
+    ASSERT_EQ(vertices(f), vertices(h));
+    ASSERT_EQ(vertices(FrozenGraph()).first, vertices(FrozenGraph()).second);}
+
+
+// ----------------------
+// TestFrozenGraphQueries
+// ----------------------
+
+// the read-only queries of TestGraph, asked of a freeze of each mutable graph type
+// FrozenGraph can't run TestGraph itself, which builds its graphs with add_vertex and add_edge
+template <typename G>
+struct TestFrozenGraphQueries : Test {
+    // --------
+    // typedefs
+    // --------
+
+    typedef          G                     graph_type;
+    typedef typename G::vertex_descriptor  vertex_descriptor;
+    typedef typename G::edge_descriptor    edge_descriptor;};
+
+typedef Types<
+            Graph,
+            ArenaGraph>
+        mutable_graph_types;
+
+TYPED_TEST_CASE(TestFrozenGraphQueries, mutable_graph_types);
+
+TYPED_TEST(TestFrozenGraphQueries, edge1) {
+    typedef typename TestFixture::graph_type         graph_type;
+    typedef typename TestFixture::vertex_descriptor  vertex_descriptor;
+    typedef typename TestFixture::edge_descriptor    edge_descriptor;
+
+    graph_type g;
+
+    vertex_descriptor vdA = add_vertex(g);
+    vertex_descriptor vdB = add_vertex(g);
+    vertex_descriptor vdC = add_vertex(g);
+    vertex_descriptor vdD = add_vertex(g);
+
+    edge_descriptor edAB = add_edge(vdA, vdB, g).first;
+    edge_descriptor edCA = add_edge(vdC, vdA, g).first;
+
+    const FrozenGraph f = freeze(g);
+
+    ASSERT_EQ(4, num_vertices(f));
+    ASSERT_EQ(2, num_edges(f));
+
+    pair<FrozenGraph::edge_descriptor, bool> p1 = edge(vdA, vdB, f);
+    ASSERT_EQ(edAB, p1.first);
+    ASSERT_EQ(true, p1.second);
+
+    pair<FrozenGraph::edge_descriptor, bool> p2 = edge(vdC, vdA, f);
+    ASSERT_EQ(edCA, p2.first);
+    ASSERT_EQ(true, p2.second);
+
+    ASSERT_FALSE(edge(vdB, vdA, f).second);
+    ASSERT_FALSE(edge(vdC, vdD, f).second);
+
+    ASSERT_EQ(vdA, source(edAB, f));
+    ASSERT_EQ(vdB, target(edAB, f));
+    ASSERT_EQ(vdC, vertex(2, f));}
+
+TYPED_TEST(TestFrozenGraphQueries, edges1) {
+    typedef typename TestFixture::graph_type         graph_type;
+    typedef typename TestFixture::vertex_descriptor  vertex_descriptor;
+    typedef typename TestFixture::edge_descriptor    edge_descriptor;
+
+    graph_type g;
+
+    vertex_descriptor vdA = add_vertex(g);
+    vertex_descriptor vdB = add_vertex(g);
+    vertex_descriptor vdC = add_vertex(g);
+    add_vertex(g);
+
+    edge_descriptor eAB = add_edge(vdA, vdB, g).first;
+    edge_descriptor eAC = add_edge(vdA, vdC, g).first;
+    edge_descriptor eCA = add_edge(vdC, vdA, g).first;
+
+    const FrozenGraph f = freeze(g);
+
+    pair<FrozenGraph::edge_iterator, FrozenGraph::edge_iterator> p = edges(f);
+    FrozenGraph::edge_iterator                                   b = p.first;
+    FrozenGraph::edge_iterator                                   e = p.second;
+    ASSERT_TRUE(b != e);
+    ASSERT_EQ(eAB, *b);
+    ++b;
+    ASSERT_TRUE(b != e);
+    ASSERT_EQ(eAC, *b);
+    ++b;
+    ASSERT_TRUE(b != e);
+    ASSERT_EQ(eCA, *b);
+    ++b;
+    ASSERT_TRUE(b == e);}
+
+TYPED_TEST(TestFrozenGraphQueries, adjacent_vertices1) {
+    typedef typename TestFixture::graph_type         graph_type;
+    typedef typename TestFixture::vertex_descriptor  vertex_descriptor;
+
+    graph_type g;
+
+    vertex_descriptor vdA = add_vertex(g);
+    vertex_descriptor vdB = add_vertex(g);
+    vertex_descriptor vdC = add_vertex(g);
+
+    add_edge(vdA, vdC, g);
+    add_edge(vdA, vdB, g);
+
+    const FrozenGraph f = freeze(g);
+
+    pair<FrozenGraph::adjacency_iterator, FrozenGraph::adjacency_iterator> p = adjacent_vertices(vdA, f);
+    FrozenGraph::adjacency_iterator                                        b = p.first;
+    FrozenGraph::adjacency_iterator                                        e = p.second;
+    ASSERT_TRUE(b != e);
+    ASSERT_EQ(vdB, *b);
+    ++b;
+    ASSERT_TRUE(b != e);
+    ASSERT_EQ(vdC, *b);
+    ++b;
+    ASSERT_EQ(e, b);
+
+    p = adjacent_vertices(vdB, f);
+    ASSERT_EQ(p.first, p.second);}
+
+TYPED_TEST(TestFrozenGraphQueries, vertices1) {
+    typedef typename TestFixture::graph_type         graph_type;
+    typedef typename TestFixture::vertex_descriptor  vertex_descriptor;
+
+    graph_type g;
+
+    vertex_descriptor vdA = add_vertex(g);
+    vertex_descriptor vdB = add_vertex(g);
+
+    const FrozenGraph f = freeze(g);
+
+    pair<FrozenGraph::vertex_iterator, FrozenGraph::vertex_iterator> p = vertices(f);
+    FrozenGraph::vertex_iterator                                     b = p.first;
+    FrozenGraph::vertex_iterator                                     e = p.second;
+    ASSERT_TRUE(b != e);
+    ASSERT_EQ(vdA, *b);
+    ++b;
+    ASSERT_TRUE(b != e);
+    ASSERT_EQ(vdB, *b);
+    ++b;
+    ASSERT_TRUE(b == e);}
+
+TYPED_TEST(TestFrozenGraphQueries, queries1) {
+    typedef typename TestFixture::graph_type graph_type;
+
+    graph_type g;
+    for (int i = 0; i != 500; ++i)
+        add_edge((i * 7919) % 61, (i * 104729) % 53, g);
+
+    const FrozenGraph f = freeze(g);
+
+    ASSERT_EQ(num_vertices(g), num_vertices(f));
+    ASSERT_EQ(num_edges(g),    num_edges(f));
+    ASSERT_TRUE(equal(vertices(g).first, vertices(g).second, vertices(f).first));
+    ASSERT_TRUE(equal(edges(g).first,    edges(g).second,    edges(f).first));
+    for (int u = 0; u != 61; ++u) {
+        ASSERT_EQ(distance(adjacent_vertices(u, g).first, adjacent_vertices(u, g).second),
+                  distance(adjacent_vertices(u, f).first, adjacent_vertices(u, f).second));
+        ASSERT_TRUE(equal(adjacent_vertices(u, g).first, adjacent_vertices(u, g).second, adjacent_vertices(u, f).first));
+        for (int v = 0; v != 61; ++v)
+            ASSERT_EQ(edge(u, v, g), edge(u, v, f));}}
+
+
+// --------------
+// TestArenaGraph
+// --------------
+
+TEST(TestArenaGraph, arena1) {
+    Arena a(16);
+
+    char*   p = static_cast<char*>(a.allocate(3, 1));
+    double* q = static_cast<double*>(a.allocate(sizeof(double), alignof(double)));
+    char*   r = static_cast<char*>(a.allocate(100, 1));
+    ASSERT_EQ(0, reinterpret_cast<uintptr_t>(q) % alignof(double));
+    ASSERT_NE(p, r);
+    ASSERT_LE(3 + sizeof(double) + 100, a.bytes_reserved());}
+
+TEST(TestArenaGraph, arena2) {
+    ArenaGraph g;
+
+    for (int i = 0; i != 100; ++i)
+        add_edge(i, (i * 37) % 100, g);
+
+    ASSERT_EQ(100, num_edges(g));
+    ASSERT_TRUE(g.get_allocator().arena() != 0);
+    ASSERT_LT(0, g.get_allocator().arena()->bytes_reserved());
+    ASSERT_EQ(sizeof(Graph::adjacency_type) + sizeof(Arena*), sizeof(ArenaGraph::adjacency_type));}
+
+TEST(TestArenaGraph, arena3) {
+    Arena      a;
+    ArenaGraph g((ArenaAllocator<int>(&a)));
+
+    add_edge(2, 1, g);
+    add_edge(0, 2, g);
+
+    ASSERT_EQ(&a, g.get_allocator().arena());
+    ASSERT_LT(0,  a.bytes_reserved());
+
+    ArenaGraph h = g;
+    add_edge(1, 0, h);
+    ASSERT_EQ(2, num_edges(g));
+    ASSERT_EQ(3, num_edges(h));
+    ASSERT_TRUE(h.get_allocator().arena() != 0);
+    ASSERT_TRUE(h.get_allocator() != g.get_allocator());
+
+    ArenaGraph k = h;
+    ASSERT_TRUE(k.get_allocator() != h.get_allocator());
+    k = g;
+    ASSERT_EQ(2, num_edges(k));
+    ASSERT_TRUE(k.get_allocator() != g.get_allocator());
+    ArenaGraph m(std::move(k));
+    ASSERT_EQ(2, num_edges(m));
+    ASSERT_TRUE(edge(0, 2, m).second);}
+
+TEST(TestArenaGraph, arena4) {
+    vector<Graph::edge_descriptor> v;
+    for (int i = 0; i != 300; ++i)
+        v.push_back(make_pair((i * 7919) % 41, (i * 104729) % 43));
+
+    Graph      g(v.begin(), v.end());
+    ArenaGraph h(v.begin(), v.end());
+    add_edges(v.begin(), v.end(), h);
+
+    ASSERT_EQ(num_vertices(g), num_vertices(h));
+    ASSERT_EQ(num_edges(g),    num_edges(h));
+    ASSERT_TRUE(equal(edges(g).first, edges(g).second, edges(h).first));
+
+    FrozenGraph f = freeze(h);
+    ASSERT_TRUE(equal(edges(g).first, edges(g).second, edges(f).first));}
+
+// -------------------
+// TestConcurrentGraph
+// -------------------
+
+TEST(TestConcurrentGraph, add_edge1) {
+    ConcurrentGraph g;
+
+    ASSERT_TRUE (add_edge(0, 2, g).second);
+    ASSERT_TRUE (add_edge(0, 1, g).second);
+    ASSERT_FALSE(add_edge(0, 2, g).second);
+    ASSERT_EQ(3, num_vertices(g));
+    ASSERT_EQ(2, num_edges(g));
+    ASSERT_TRUE (edge(0, 1, g).second);
+    ASSERT_FALSE(edge(1, 0, g).second);
+    ASSERT_FALSE(edge(9, 0, g).second);
+
+    ConcurrentGraph::adjacency_type a = adjacent_vertices(0, g);
+    ASSERT_EQ(2, a.size());
+    ASSERT_EQ(1, a[0]);
+    ASSERT_EQ(2, a[1]);}
+
+TEST(TestConcurrentGraph, add_vertex1) {
+    ConcurrentGraph g;
+
+    ASSERT_EQ(0, add_vertex(g));
+    ASSERT_EQ(1, add_vertex(g));
+    add_edge(5000, 3, g);
+    ASSERT_EQ(5001, add_vertex(g));
+    ASSERT_EQ(5002, num_vertices(g));
+    ASSERT_TRUE(adjacent_vertices(4999, g).empty());}
+
+TEST(TestConcurrentGraph, add_vertex2) {
+    ConcurrentGraph g;
+
+    const int t = 8;
+    const int m = 2000;
+    vector<vector<int> > ids(t);
+    vector<thread>       threads;
+    for (int i = 0; i != t; ++i)
+        threads.push_back(thread([&, i] {
+            for (int j = 0; j != m; ++j)
+                ids[i].push_back(add_vertex(g));}));
+    for (int i = 0; i != t; ++i)
+        threads[i].join();
+
+    vector<int> all;
+    for (int i = 0; i != t; ++i)
+        all.insert(all.end(), ids[i].begin(), ids[i].end());
+    sort(all.begin(), all.end());
+    ASSERT_EQ(t * m, num_vertices(g));
+    for (int i = 0; i != t * m; ++i)
+        ASSERT_EQ(i, all[i]);}
+
+TEST(TestConcurrentGraph, stress1) {
+    const int t = 8;
+    const int m = 20000;
+    vector<Graph::edge_descriptor> v;
+    unsigned x = 378;
+    for (int i = 0; i != t * m; ++i) {
+        x = x * 1103515245 + 12345;
+        int a = (x >> 8) % 30000;
+        x = x * 1103515245 + 12345;
+        int b = (x >> 8) % ((i % 4 == 0) ? 50 : 30000);
+        v.push_back(make_pair(a, b));}
+
+    ConcurrentGraph   g;
+    atomic<bool>      done(false);
+    atomic<long>      seen(0);
+    vector<thread>    threads;
+    for (int i = 0; i != t; ++i)
+        threads.push_back(thread([&, i] {
+            for (int j = i; j < t * m; j += t)
+                add_edge(v[j].first, v[j].second, g);}));
+    thread reader([&] {
+        while (!done) {
+            for (int j = 0; j < t * m; j += 997) {
+                seen += edge(v[j].first, v[j].second, g).second;
+                if (v[j].first < (int) num_vertices(g))
+                    seen += adjacent_vertices(v[j].first, g).size();}}});
+    for (int i = 0; i != t; ++i)
+        threads[i].join();
+    done = true;
+    reader.join();
+
+    Graph       h(v.begin(), v.end());
+    FrozenGraph f = freeze(g);
+    ASSERT_EQ(num_vertices(h), num_vertices(g));
+    ASSERT_EQ(num_edges(h),    num_edges(g));
+    ASSERT_EQ(num_edges(h),    num_edges(f));
+    ASSERT_TRUE(equal(edges(h).first, edges(h).second, edges(f).first));}
+
+// -------------------
+// TestGraphAlgorithms
+// -------------------
+
+namespace {
+
+typedef boost::adjacency_list<boost::setS, boost::vecS, boost::directedS> boost_graph;
+
+/**
+ * n vertices and about m edges from a fixed pseudo-random sequence
+ * when dag, every edge goes from a lower to a higher vertex
+ */
+vector<Graph::edge_descriptor> random_edges (int n, int m, bool dag) {
+    vector<Graph::edge_descriptor> v;
+    unsigned x = 12345;
+    for (int i = 0; i != m; ++i) {
+        x = x * 1103515245 + 12345;
+        int a = (x >> 8) % n;
+        x = x * 1103515245 + 12345;
+        int b = (x >> 8) % n;
+        if (dag && (a == b))
+            continue;
+        if (dag && (a > b))
+            swap(a, b);
+        v.push_back(make_pair(a, b));}
+    v.push_back(make_pair(n - 1, n - 1 - (dag ? 0 : 1)));
+    if (dag)
+        v.pop_back();
+    return v;}
+
+vector<int> boost_levels (int s, const boost_graph& b) {
+    vector<int> d(num_vertices(b), -1);
+    d[s] = 0;
+    boost::breadth_first_search(b, s, boost::visitor(boost::make_bfs_visitor(boost::record_distances(&d[0], boost::on_tree_edge()))));
+    return d;}
+
+}
+
+TEST(TestGraphAlgorithms, breadth_first_levels1) {
+    Graph g;
+
+    add_edge(0, 1, g);
+    add_edge(1, 2, g);
+    add_edge(0, 3, g);
+    add_edge(4, 0, g);
+
+    ThreadPool p(1);
+    vector<int> d = breadth_first_levels(0, g, p);
+    ASSERT_EQ(5,  d.size());
+    ASSERT_EQ(0,  d[0]);
+    ASSERT_EQ(1,  d[1]);
+    ASSERT_EQ(2,  d[2]);
+    ASSERT_EQ(1,  d[3]);
+    ASSERT_EQ(-1, d[4]);}
+
+TEST(TestGraphAlgorithms, breadth_first_levels2) {
+    vector<Graph::edge_descriptor> v = random_edges(2000, 20000, false);
+    Graph       g(v.begin(), v.end());
+    boost_graph b(v.begin(), v.end(), num_vertices(g));
+
+    ThreadPool p(4);
+    for (int s = 0; s < 2000; s += 397)
+        ASSERT_EQ(boost_levels(s, b), breadth_first_levels(s, g, p));}
+
+TEST(TestGraphAlgorithms, breadth_first_levels3) {
+    vector<Graph::edge_descriptor> v = random_edges(5000, 6000, false);
+    Graph       g(v.begin(), v.end());
+    boost_graph b(v.begin(), v.end(), num_vertices(g));
+    FrozenGraph f = freeze(g);
+
+    ThreadPool p(3);
+    ASSERT_EQ(boost_levels(7, b), breadth_first_levels(7, f, p));
+    ASSERT_EQ(boost_levels(7, b), breadth_first_levels(7, g));}
+
+TEST(TestGraphAlgorithms, breadth_first_levels4) {
+    vector<Graph::edge_descriptor> v = random_edges(3000, 15000, false);
+    Graph       g(v.begin(), v.end());
+    boost_graph b(v.begin(), v.end(), num_vertices(g));
+    const vector<int> d1 = boost_levels(3,  b);
+    const vector<int> d2 = boost_levels(11, b);
+
+    ThreadPool     p(4);
+    atomic<int>    bad(0);
+    vector<thread> threads;
+    for (int i = 0; i != 2; ++i)
+        threads.push_back(thread([&, i] {
+            for (int j = 0; j != 50; ++j)
+                if (breadth_first_levels((i == 0) ? 3 : 11, g, p) != ((i == 0) ? d1 : d2))
+                    ++bad;}));
+    for (int i = 0; i != 2; ++i)
+        threads[i].join();
+    ASSERT_EQ(0, bad);}
+
+TEST(TestGraphAlgorithms, breadth_first_levels5) {
+    Graph       g;
+    FrozenGraph f;
+    ASSERT_TRUE(breadth_first_levels(0, g).empty());
+    ASSERT_TRUE(breadth_first_levels(0, f).empty());}
+
+TEST(TestGraphAlgorithms, parallel_for1) {
+    ThreadPool  p(3);
+    atomic<int> n(0);
+    p.parallel_for(0, 40, 1, [&] (size_t b, size_t e, size_t w) {
+        ASSERT_LT(w, p.size());
+        for (size_t i = b; i != e; ++i)
+            p.parallel_for(0, 25, 5, [&] (size_t c, size_t d, size_t) {
+                n += d - c;});});
+    ASSERT_EQ(40 * 25, n);}
+
+TEST(TestGraphAlgorithms, topological_order1) {
+    Graph g;
+
+    add_edge(3, 1, g);
+    add_edge(1, 0, g);
+    add_edge(3, 2, g);
+    add_edge(2, 0, g);
+
+    ThreadPool p(2);
+    vector<int> o = topological_order(g, p);
+    ASSERT_EQ(4, o.size());
+    ASSERT_EQ(3, o[0]);
+    ASSERT_EQ(0, o[3]);}
+
+TEST(TestGraphAlgorithms, topological_order2) {
+    vector<Graph::edge_descriptor> v = random_edges(3000, 30000, true);
+    Graph       g(v.begin(), v.end());
+    boost_graph b(v.begin(), v.end(), num_vertices(g));
+
+    vector<boost_graph::vertex_descriptor> r;
+    boost::topological_sort(b, back_inserter(r));
+
+    ThreadPool p(4);
+    vector<int> o = topological_order(g, p);
+    ASSERT_EQ(r.size(), o.size());
+
+    vector<int> at(o.size(), -1);
+    for (size_t i = 0; i != o.size(); ++i)
+        at[o[i]] = i;
+    for (Graph::edge_iterator i = edges(g).first; i != edges(g).second; ++i)
+        ASSERT_LT(at[(*i).first], at[(*i).second]);}
+
+TEST(TestGraphAlgorithms, topological_order3) {
+    vector<Graph::edge_descriptor> v = random_edges(300, 3000, false);
+    Graph       g(v.begin(), v.end());
+    boost_graph b(v.begin(), v.end(), num_vertices(g));
+
+    vector<boost_graph::vertex_descriptor> r;
+    ASSERT_THROW(boost::topological_sort(b, back_inserter(r)), boost::not_a_dag);
+    ASSERT_THROW(topological_order(g),                          invalid_argument);}
+
+TEST(TestGraphAlgorithms, intersect_sorted1) {
+    unsigned x = 7;
+    for (int t = 0; t != 300; ++t) {
+        vector<int> a;
+        vector<int> b;
+        for (int v = 0; v != 200; ++v) {
+            x = x * 1103515245 + 12345;
+            if ((x >> 8) % 7 < (unsigned) t % 5)
+                a.push_back(v);
+            x = x * 1103515245 + 12345;
+            if ((x >> 8) % 7 < (unsigned) t % 3 + 1)
+                b.push_back(v);}
+        a.resize(a.size() - min(a.size(), (size_t) t % 13));
+
+        vector<int> r;
+        set_intersection(a.begin(), a.end(), b.begin(), b.end(), back_inserter(r));
+
+        const intersect_kernel ks[] = {scalar_kernel, sse2_kernel, avx2_kernel};
+        for (int k = 0; k != 3; ++k) {
+            if (!kernel_supported(ks[k]))
+                continue;
+            vector<int> out(min(a.size(), b.size()) + 1, -1);
+            const int*  pa = a.empty() ? 0 : &a[0];
+            const int*  pb = b.empty() ? 0 : &b[0];
+            ASSERT_EQ(r.size(), intersect_sorted(pa, a.size(), pb, b.size(), 0,       ks[k]));
+            ASSERT_EQ(r.size(), intersect_sorted(pa, a.size(), pb, b.size(), &out[0], ks[k]));
+            ASSERT_TRUE(equal(r.begin(), r.end(), out.begin()));}}}
+
+TEST(TestGraphAlgorithms, common_neighbors1) {
+    Graph g;
+
+    add_edge(0, 1, g);
+    add_edge(0, 3, g);
+    add_edge(0, 4, g);
+    add_edge(2, 4, g);
+    add_edge(2, 3, g);
+    add_edge(2, 2, g);
+
+    vector<int> c = common_neighbors(0, 2, g);
+    ASSERT_EQ(2, c.size());
+    ASSERT_EQ(3, c[0]);
+    ASSERT_EQ(4, c[1]);
+    ASSERT_TRUE(common_neighbors(0, 1, g).empty());
+    ASSERT_EQ(c, common_neighbors(2, 0, freeze(g)));}
+
+namespace {
+
+/**
+ * triangles of the undirected view through each vertex, by checking every triple
+ */
+vector<long> brute_force_triangles (const Graph& g) {
+    const int n = num_vertices(g);
+    vector<vector<bool> > m(n, vector<bool>(n, false));
+    for (Graph::edge_iterator i = edges(g).first; i != edges(g).second; ++i)
+        if ((*i).first != (*i).second)
+            m[(*i).first][(*i).second] = m[(*i).second][(*i).first] = true;
+    vector<long> t(n, 0);
+    for (int a = 0; a != n; ++a)
+        for (int b = a + 1; b != n; ++b)
+            for (int c = b + 1; c != n; ++c)
+                if (m[a][b] && m[b][c] && m[a][c]) {
+                    ++t[a];
+                    ++t[b];
+                    ++t[c];}
+    return t;}
+
+}
+
+TEST(TestGraphAlgorithms, count_triangles1) {
+    Graph g;
+
+    add_edge(0, 1, g);
+    add_edge(1, 2, g);
+    add_edge(2, 0, g);
+    add_edge(0, 2, g);
+    add_edge(2, 3, g);
+    add_edge(3, 3, g);
+
+    ASSERT_EQ(1, count_triangles(g));
+
+    vector<double> c = local_clustering_coefficients(g);
+    ASSERT_EQ(4, c.size());
+    ASSERT_DOUBLE_EQ(1,       c[0]);
+    ASSERT_DOUBLE_EQ(1,       c[1]);
+    ASSERT_DOUBLE_EQ(1.0 / 3, c[2]);
+    ASSERT_DOUBLE_EQ(0,       c[3]);}
+
+TEST(TestGraphAlgorithms, count_triangles2) {
+    vector<Graph::edge_descriptor> v = random_edges(120, 2500, false);
+    for (int i = 1; i != 120; ++i)
+        v.push_back(make_pair(0, i));
+    Graph g(v.begin(), v.end());
+
+    vector<long> t = brute_force_triangles(g);
+    long         s = 0;
+    for (size_t i = 0; i != t.size(); ++i)
+        s += t[i];
+
+    ThreadPool p(4);
+    const intersect_kernel ks[] = {scalar_kernel, sse2_kernel, avx2_kernel};
+    for (int k = 0; k != 3; ++k) {
+        if (!kernel_supported(ks[k]))
+            continue;
+        ASSERT_EQ(s / 3, count_triangles(g, p, ks[k]));
+
+        vector<double> c = local_clustering_coefficients(freeze(g), p, ks[k]);
+        for (int u = 0; u != 120; ++u) {
+            set<int> d;
+            for (Graph::edge_iterator i = edges(g).first; i != edges(g).second; ++i) {
+                if ((*i).first == (*i).second)
+                    continue;
+                if ((*i).first  == u)
+                    d.insert((*i).second);
+                if ((*i).second == u)
+                    d.insert((*i).first);}
+            const double n = d.size();
+            ASSERT_DOUBLE_EQ((n < 2) ? 0 : t[u] / (n * (n - 1) / 2), c[u]);}}}
+
+TEST(TestGraphAlgorithms, relabel1) {
+    Graph g;
+
+    add_edge(0, 1, g);
+    add_edge(0, 2, g);
+    add_edge(2, 1, g);
+    add_edge(3, 3, g);
+
+    vector<int> p = {2, 0, 3, 1};
+    relabel(p, g);
+    ASSERT_EQ(4, num_vertices(g));
+    ASSERT_EQ(4, num_edges(g));
+    ASSERT_TRUE(edge(2, 0, g).second);
+    ASSERT_TRUE(edge(2, 3, g).second);
+    ASSERT_TRUE(edge(3, 0, g).second);
+    ASSERT_TRUE(edge(1, 1, g).second);
+    ASSERT_FALSE(edge(0, 1, g).second);
+
+    Graph::adjacency_iterator b = adjacent_vertices(2, g).first;
+    ASSERT_EQ(0, *b);
+    ASSERT_EQ(3, *++b);
+
+    ASSERT_EQ(vector<int>({1, 3, 0, 2}), inverse_permutation(p));}
+
+TEST(TestGraphAlgorithms, relabel2) {
+    ArenaGraph g;
+
+    add_edge(0, 1, g);
+    add_edge(1, 2, g);
+
+    vector<int> p = {0, 0, 1};
+    ASSERT_THROW(relabel(p, g), invalid_argument);
+    p = {0, 1};
+    ASSERT_THROW(relabel(p, g), invalid_argument);
+    p = {0, 1, 3};
+    ASSERT_THROW(relabel(p, g), invalid_argument);
+    ASSERT_TRUE(edge(0, 1, g).second);
+    ASSERT_TRUE(edge(1, 2, g).second);}
+
+TEST(TestGraphAlgorithms, degree_order1) {
+    Graph g;
+
+    for (int v = 0; v != 6; ++v)
+        if (v != 4)
+            add_edge(v, 4, g);
+    add_edge(1, 5, g);
+
+    vector<int> p = degree_order(g);
+    ASSERT_EQ(vector<int>({3, 1, 4, 5, 0, 2}), p);}
+
+TEST(TestGraphAlgorithms, cuthill_mckee_order1) {
+    vector<int> q(500);
+    for (int v = 0; v != 500; ++v)
+        q[v] = v;
+    random_shuffle(q.begin(), q.end());
+
+    Graph g;
+    for (int v = 0; v + 1 != 500; ++v)
+        add_edge(q[v + 1], q[v], g);
+
+    vector<int> p = cuthill_mckee_order(g);
+    for (Graph::edge_iterator i = edges(g).first; i != edges(g).second; ++i)
+        ASSERT_EQ(1, abs(p[(*i).first] - p[(*i).second]));}
+
+TEST(TestGraphAlgorithms, reorder1) {
+    vector<Graph::edge_descriptor> v = random_edges(3000, 12000, false);
+    const Graph g(v.begin(), v.end());
+    const vector<int> d = breadth_first_levels(5, g);
+
+    ThreadPool p(2);
+    const vertex_ordering os[] = {degree_ordering, cuthill_mckee_ordering, bfs_ordering};
+    for (int k = 0; k != 3; ++k) {
+        Graph h = g;
+        vector<int> r = reorder(h, os[k], p);
+        vector<int> s = inverse_permutation(r);
+        ASSERT_EQ(num_vertices(g), num_vertices(h));
+        ASSERT_EQ(num_edges(g),    num_edges(h));
+        for (Graph::edge_iterator i = edges(g).first; i != edges(g).second; ++i)
+            ASSERT_TRUE(edge(r[(*i).first], r[(*i).second], h).second);
+        for (Graph::edge_iterator i = edges(h).first; i != edges(h).second; ++i)
+            ASSERT_TRUE(edge(s[(*i).first], s[(*i).second], g).second);
+
+        const vector<int> e = breadth_first_levels(r[5], h, p);
+        for (int u = 0; u != 3000; ++u)
+            ASSERT_EQ(d[u], e[r[u]]);}}
+
+// ------------
+// TestSaveLoad
+// ------------
+
+namespace {
+
+const char* const graph_file = "TestGraph.tmp";
+
+void truncate_graph_file (long n) {
+    ASSERT_EQ(0, truncate(graph_file, n));}
+
+void append_graph_file (const char* s) {
+    ofstream out(graph_file, ios::binary | ios::app);
+    out << s;}
+
+void patch_graph_file (long n, int32_t x) {
+    fstream out(graph_file, ios::binary | ios::in | ios::out);
+    out.seekp(n);
+    out.write(reinterpret_cast<const char*>(&x), sizeof(x));}
+
+}
+
+TEST(TestSaveLoad, load1) {
+    Graph g;
+
+    save(g, graph_file);
+    FrozenGraph f = load(graph_file);
+    remove(graph_file);
+
+    ASSERT_EQ(0, num_vertices(f));
+    ASSERT_EQ(0, num_edges(f));}
+
+TEST(TestSaveLoad, load2) {
+    Graph g;
+
+    add_edge(0, 2, g);
+    add_edge(0, 1, g);
+    add_edge(2, 0, g);
+    add_edge(4, 4, g);
+    add_vertex(g);
+
+    save(g, graph_file);
+    FrozenGraph f = load(graph_file);
+    remove(graph_file);
+
+    ASSERT_EQ(6, num_vertices(f));
+    ASSERT_EQ(4, num_edges(f));
+    ASSERT_TRUE (edge(0, 1, f).second);
+    ASSERT_TRUE (edge(4, 4, f).second);
+    ASSERT_FALSE(edge(1, 0, f).second);
+    ASSERT_TRUE(equal(edges(g).first, edges(g).second, edges(f).first));
+
+    pair<FrozenGraph::adjacency_iterator, FrozenGraph::adjacency_iterator> p = adjacent_vertices(0, f);
+    ASSERT_EQ(2, p.second - p.first);
+    ASSERT_EQ(1, p.first[0]);
+    ASSERT_EQ(2, p.first[1]);}
+
+TEST(TestSaveLoad, load3) {
+    Graph g;
+
+    add_edge(1, 0, g);
+    add_edge(1, 3, g);
+    add_edge(3, 2, g);
+
+    save(freeze(g), graph_file);
+    FrozenGraph f1 = load(graph_file);
+    remove(graph_file);
+    FrozenGraph f2 = f1;
+
+    ASSERT_EQ(4, num_vertices(f2));
+    ASSERT_EQ(3, num_edges(f2));
+    ASSERT_TRUE(equal(edges(g).first, edges(g).second, edges(f2).first));}
+
+TEST(TestSaveLoad, load4) {
+    ASSERT_THROW(load(graph_file), runtime_error);}
+
+TEST(TestSaveLoad, load5) {
+    Graph g;
+
+    add_edge(0, 1, g);
+
+    save(g, graph_file);
+    truncate_graph_file(12);
+    ASSERT_THROW(load(graph_file), runtime_error);
+    remove(graph_file);}
+
+TEST(TestSaveLoad, load6) {
+    Graph g;
+
+    add_edge(0, 1, g);
+    add_edge(0, 2, g);
+    add_edge(2, 1, g);
+
+    save(g, graph_file);
+    truncate_graph_file(sizeof(GraphFileHeader) + 4 * sizeof(FrozenGraph::offset_type) + 2 * sizeof(int32_t));
+    ASSERT_THROW(load(graph_file), runtime_error);
+    remove(graph_file);}
+
+TEST(TestSaveLoad, load7) {
+    Graph g;
+
+    add_edge(0, 1, g);
+
+    save(g, graph_file);
+    append_graph_file("x");
+    ASSERT_THROW(load(graph_file), runtime_error);
+    remove(graph_file);}
+
+TEST(TestSaveLoad, load8) {
+    Graph g;
+
+    add_edge(0, 1, g);
+
+    save(g, graph_file);
+    patch_graph_file(0, 0);
+    ASSERT_THROW(load(graph_file), runtime_error);
+    remove(graph_file);}
+
+TEST(TestSaveLoad, load9) {
+    Graph g;
+
+    add_edge(0, 1, g);
+
+    save(g, graph_file);
+    patch_graph_file(sizeof(GraphFileHeader) + 3 * sizeof(FrozenGraph::offset_type), 7);
+    FrozenGraph f = load(graph_file);
+    ASSERT_FALSE(verify(f));
+    remove(graph_file);}
+
+TEST(TestSaveLoad, load10) {
+    Graph g;
+
+    for (int i = 0; i != 507; ++i)
+        add_vertex(g);
+
+    save(g, graph_file);
+    patch_graph_file(sizeof(GraphFileHeader) + sizeof(FrozenGraph::offset_type), 1);
+    ASSERT_THROW(load(graph_file), runtime_error);
+    remove(graph_file);}
+
+TEST(TestSaveLoad, load11) {
+    Graph g;
+
+    add_edge(0, 1, g);
+    add_edge(1, 0, g);
+    add_edge(1, 2, g);
+
+    save(g, graph_file);
+    FrozenGraph f = load(graph_file);
+    ASSERT_TRUE(verify(f));
+    ASSERT_TRUE(verify(freeze(g)));
+    remove(graph_file);}
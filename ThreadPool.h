@@ -0,0 +1,221 @@
+// -------------------------------
+// projects/c++/graph/ThreadPool.h
+// Copyright (C) 2015
+// Glenn P. Downing
+// -------------------------------
+
+#ifndef ThreadPool_h
+#define ThreadPool_h
+
+// --------
+// includes
+// --------
+
+#include <algorithm>          // max, min
+#include <atomic>             // atomic
+#include <cassert>            // assert
+#include <condition_variable> // condition_variable
+#include <cstddef>            // size_t
+#include <cstdint>            // uint32_t, uint64_t
+#include <functional>         // function
+#include <memory>             // unique_ptr
+#include <mutex>              // mutex, unique_lock
+#include <thread>             // thread
+#include <vector>             // vector
+
+// ----------
+// ThreadPool
+// ----------
+
+/**
+ * fixed set of worker threads that run parallel loops
+ * a loop's chunks are dealt out evenly, each worker takes chunks from the front of its own range,
+ * and a worker that runs out steals the back half of another worker's range
+ * the calling thread takes part as worker 0, so a pool of size 1 runs loops inline
+ * one loop runs on the workers at a time; a loop started while the pool is busy,
+ * from another thread or from inside a running loop, runs inline on its caller instead
+ */
+class ThreadPool {
+    private:
+        // ----
+        // data
+        // ----
+
+        std::vector<std::thread>                 _threads;
+        std::mutex                               _busy;
+        std::mutex                               _m;
+        std::condition_variable                  _start;
+        std::condition_variable                  _finish;
+        std::size_t                              _generation;
+        std::size_t                              _running;
+        bool                                     _stop;
+        std::function<void (std::size_t)>        _job;
+        std::unique_ptr<std::atomic<std::uint64_t>[]> _ranges;
+
+        // -----
+        // range
+        // -----
+
+        static std::uint64_t pack (std::uint32_t b, std::uint32_t e) {
+            return (std::uint64_t(b) << 32) | e;}
+
+        static std::uint32_t lo (std::uint64_t r) {
+            return r >> 32;}
+
+        static std::uint32_t hi (std::uint64_t r) {
+            return r & 0xFFFFFFFFu;}
+
+        /**
+         * @param worker id
+         * @param chunk index out
+         * takes the next chunk from the front of the worker's own range
+         * @return false if the range is empty
+         */
+        bool pop (std::size_t w, std::uint32_t& c) {
+            std::uint64_t r = _ranges[w].load();
+            while (lo(r) < hi(r)) {
+                if (_ranges[w].compare_exchange_weak(r, pack(lo(r) + 1, hi(r)))) {
+                    c = lo(r);
+                    return true;}}
+            return false;}
+
+        /**
+         * @param worker id
+         * moves the back half of some other worker's range into this worker's range
+         * @return false if every range is empty
+         */
+        bool steal (std::size_t w) {
+            const std::size_t n = size();
+            for (std::size_t i = 1; i != n; ++i) {
+                const std::size_t v = (w + i) % n;
+                std::uint64_t     r = _ranges[v].load();
+                while (lo(r) < hi(r)) {
+                    const std::uint32_t m = lo(r) + (hi(r) - lo(r)) / 2;
+                    if (_ranges[v].compare_exchange_weak(r, pack(lo(r), m))) {
+                        _ranges[w].store(pack(m, hi(r)));
+                        return true;}}}
+            return false;}
+
+        /**
+         * @param worker id
+         * runs the current job, then reports back
+         */
+        void work (std::size_t w) {
+            _job(w);
+            std::unique_lock<std::mutex> l(_m);
+            if (--_running == 0)
+                _finish.notify_all();}
+
+        /**
+         * @param worker id
+         * waits for a new generation of work until the pool stops
+         */
+        void loop (std::size_t w) {
+            std::size_t g = 0;
+            while (true) {
+                {
+                std::unique_lock<std::mutex> l(_m);
+                while (!_stop && (_generation == g))
+                    _start.wait(l);
+                if (_stop)
+                    return;
+                g = _generation;
+                }
+                work(w);}}
+
+    public:
+        // ------------
+        // constructors
+        // ------------
+
+        /**
+         * @param number of workers, including the calling thread, defaults to the number of cores
+         */
+        explicit ThreadPool (std::size_t n = std::max(1u, std::thread::hardware_concurrency())) :
+                _generation (0),
+                _running    (0),
+                _stop       (false),
+                _ranges     (new std::atomic<std::uint64_t>[std::max<std::size_t>(n, 1)]) {
+            for (std::size_t w = 1; w < n; ++w)
+                _threads.push_back(std::thread(&ThreadPool::loop, this, w));}
+
+        ~ThreadPool () {
+            {
+            std::unique_lock<std::mutex> l(_m);
+            _stop = true;
+            }
+            _start.notify_all();
+            for (std::size_t w = 0; w != _threads.size(); ++w)
+                _threads[w].join();}
+
+        ThreadPool             (const ThreadPool&) = delete;
+        ThreadPool& operator = (const ThreadPool&) = delete;
+
+        // ----
+        // size
+        // ----
+
+        /**
+         * @return number of workers, including the calling thread
+         */
+        std::size_t size () const {
+            return _threads.size() + 1;}
+
+        // ------------
+        // parallel_for
+        // ------------
+
+        /**
+         * @param beginning of the index range
+         * @param end of the index range
+         * @param number of indices per chunk
+         * @param f(b, e, w) called for every chunk [b, e) by worker w, w < size()
+         * returns when every chunk has run
+         * safe to call from several threads at once, and from inside f
+         */
+        template <typename F>
+        void parallel_for (std::size_t b, std::size_t e, std::size_t grain, F f) {
+            if (b >= e)
+                return;
+            grain = std::max<std::size_t>(grain, 1);
+            const std::size_t c = (e - b + grain - 1) / grain;
+            const std::size_t n = size();
+            std::unique_lock<std::mutex> busy(_busy, std::defer_lock);
+            if ((n == 1) || (c == 1) || !busy.try_lock()) {
+                f(b, e, 0);
+                return;}
+            assert(c <= 0xFFFFFFFFu);
+
+            for (std::size_t w = 0; w != n; ++w)
+                _ranges[w].store(pack(c * w / n, c * (w + 1) / n));
+
+            _job = [this, b, e, grain, &f] (std::size_t w) {
+                std::uint32_t k;
+                do {
+                    while (pop(w, k))
+                        f(b + k * grain, std::min(e, b + (k + 1) * grain), w);}
+                while (steal(w));};
+
+            {
+            std::unique_lock<std::mutex> l(_m);
+            _running = n;
+            ++_generation;
+            }
+            _start.notify_all();
+            work(0);
+            std::unique_lock<std::mutex> l(_m);
+            while (_running != 0)
+                _finish.wait(l);}};
+
+// ------------
+// default_pool
+// ------------
+
+/**
+ * @return pool with one worker per core, shared by add_edges and the graph algorithms
+ */
+inline ThreadPool& default_pool () {
+    static ThreadPool p;
+    return p;}
+
+#endif // ThreadPool_h